@@ -0,0 +1,927 @@
+/*
+** ByteArraySerialisation
+** File description:
+** Microbenchmarks of pushData/popData, popDataArray and Serializable round-trips.
+** Usage: bas_bench [--filter=substring] [--min-time=seconds] [--json | --csv]
+*/
+
+#include "bas.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+////////////////////////////////////////////
+// Allocation counting
+// The replacements are not inlined, else GCC sees std::free called on memory from operator new
+// and warns with -Wmismatched-new-delete
+
+static std::atomic<size_t> allocations { 0 };
+
+__attribute__((noinline)) void* operator new(size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size ? size : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+__attribute__((noinline)) void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+__attribute__((noinline)) void operator delete(void* ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+__attribute__((noinline)) void* operator new(size_t size, std::align_val_t alignment)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::aligned_alloc(size_t(alignment), (size + size_t(alignment) - 1) & ~(size_t(alignment) - 1)))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+__attribute__((noinline)) void operator delete(void* ptr, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+
+__attribute__((noinline)) void operator delete(void* ptr, size_t, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+
+////////////////////////////////////////////
+
+template <typename T>
+inline void doNotOptimize(const T& value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+struct Result {
+    std::string name;
+    size_t bytes;      // Payload Bytes processed by one operation
+    size_t iterations;
+    double nsPerOp;
+    double allocsPerOp;
+};
+
+class Bench {
+public:
+    using Function = std::function<void(size_t iterations)>;
+
+    /**
+     * @brief Register a benchmark.
+     * @param name Name of the benchmark.
+     * @param bytes Payload Bytes processed by one operation, used to compute the throughput.
+     * @param function Runs the benchmarked operation iterations times.
+     */
+    void add(const std::string& name, size_t bytes, Function function)
+    {
+        _benchmarks.push_back({ name, bytes, function });
+    }
+
+    std::vector<Result> run(const std::string& filter, double minTime)
+    {
+        std::vector<Result> results;
+
+        for (Benchmark& benchmark : _benchmarks) {
+            if (benchmark.name.find(filter) == std::string::npos)
+                continue;
+            results.push_back(measure(benchmark, minTime));
+        }
+        return results;
+    }
+
+private:
+    struct Benchmark {
+        std::string name;
+        size_t bytes;
+        Function function;
+    };
+
+    static Result measure(Benchmark& benchmark, double minTime)
+    {
+        size_t iterations = 1;
+        double elapsed = 0;
+        size_t allocated = 0;
+
+        benchmark.function(1); // Warm-up
+        while (true) {
+            size_t before = allocations.load(std::memory_order_relaxed);
+            auto start = std::chrono::steady_clock::now();
+
+            benchmark.function(iterations);
+
+            auto stop = std::chrono::steady_clock::now();
+            allocated = allocations.load(std::memory_order_relaxed) - before;
+            elapsed = std::chrono::duration<double>(stop - start).count();
+            if (elapsed >= minTime || iterations >= (size_t(1) << 40))
+                break;
+            iterations = elapsed > 0 ? std::max(iterations * 2, size_t(iterations * minTime * 1.2 / elapsed)) : iterations * 100;
+        }
+        return { benchmark.name, benchmark.bytes, iterations, elapsed * 1e9 / iterations,
+            double(allocated) / iterations };
+    }
+
+    std::vector<Benchmark> _benchmarks;
+};
+
+////////////////////////////////////////////
+// Serializable used by the round-trip benchmarks, same as in examples/intrication.cpp
+
+class SerializableWallet : public bas::Serializable {
+public:
+    SerializableWallet(const std::vector<int>& money, const std::string& id_card)
+        : money(money)
+        , id_card(id_card)
+    {
+    }
+
+    void makeSerialization(bas::SerializedObject& obj) override
+    {
+        obj.pushData(money);
+        obj.pushData(id_card);
+    }
+
+    void makeUnserialization(bas::SerializedObject& obj) override
+    {
+        money = obj.popData<std::vector<int>>();
+        id_card = obj.popData<std::string>();
+    }
+
+    std::vector<int> money;
+    std::string id_card;
+};
+
+class SerializablePerson : public bas::Serializable {
+public:
+    SerializablePerson(const std::string& name, int age, const SerializableWallet& wallet)
+        : name(name)
+        , age(age)
+        , wallet(wallet)
+    {
+    }
+
+    void makeSerialization(bas::SerializedObject& obj) override
+    {
+        obj.pushData(name);
+        obj.pushData(age);
+        obj.pushData(wallet.serialize());
+    }
+
+    void makeUnserialization(bas::SerializedObject& obj) override
+    {
+        name = obj.popData<std::string>();
+        age = obj.popData<int>();
+        wallet.unserialize(obj.popData<bas::SerializedObject>());
+    }
+
+    std::string name;
+    int age;
+    SerializableWallet wallet;
+};
+
+class InPlacePerson : public SerializablePerson {
+public:
+    using SerializablePerson::SerializablePerson;
+
+    void makeSerialization(bas::SerializedObject& obj) override
+    {
+        obj.pushData(name);
+        obj.pushData(age);
+        obj.pushObject(wallet);
+    }
+
+    void makeUnserialization(bas::SerializedObject& obj) override
+    {
+        name = obj.popData<std::string>();
+        age = obj.popData<int>();
+        obj.popObject(wallet);
+    }
+};
+
+class ReflectableWallet : public bas::Reflectable<ReflectableWallet> {
+public:
+    BAS_FIELDS(money, id_card)
+
+    std::vector<int> money;
+    std::string id_card;
+};
+
+class ReflectablePerson : public bas::Reflectable<ReflectablePerson> {
+public:
+    BAS_FIELDS(name, age, wallet)
+
+    std::string name;
+    int age;
+    ReflectableWallet wallet;
+};
+
+////////////////////////////////////////////
+
+using BigEndianLayout = bas::FixedLayout<_BAS_SIZE_BYTES_, _BAS_ARRAY_SIZE_, _BAS_CHECKSUM_SIZE_, bas::Endian::Big>;
+using Crc32cLayout = bas::Crc32cLayout<bas::DefaultLayout>;
+
+static const size_t STRING_SIZES[] = { 16, 256, 4096 };
+static const size_t ARRAY_SIZES[] = { 16, 1024, 16384 };
+static const size_t NESTED_SIZES[] = { 16, 1024, 8192 }; // Nested payloads must fit in _BAS_ARRAY_SIZE_
+
+static void addScalarBenchmarks(Bench& bench)
+{
+    bas::SerializedObject popped;
+
+    popped.pushData(42);
+    bench.add("push/int", popped.size(), [](size_t iterations) {
+        for (size_t i = 0; i < iterations; i++) {
+            bas::SerializedObject obj;
+            obj.pushData(int(i));
+            doNotOptimize(obj.payload());
+        }
+    });
+    bench.add("pop/int", popped.size(), [popped](size_t iterations) mutable {
+        for (size_t i = 0; i < iterations; i++) {
+            popped.rewind();
+            doNotOptimize(popped.popData<int>());
+        }
+    });
+}
+
+static void addStringBenchmarks(Bench& bench)
+{
+    for (size_t length : STRING_SIZES) {
+        std::string str(length, 'x');
+        bas::SerializedObject popped;
+        std::string suffix = "/" + std::to_string(length);
+
+        popped.pushData(str);
+        bench.add("push/string" + suffix, popped.size(), [str](size_t iterations) {
+            for (size_t i = 0; i < iterations; i++) {
+                bas::SerializedObject obj;
+                obj.pushData(str);
+                doNotOptimize(obj.payload());
+            }
+        });
+        bench.add("pop/string" + suffix, popped.size(), [popped](size_t iterations) mutable {
+            for (size_t i = 0; i < iterations; i++) {
+                popped.rewind();
+                doNotOptimize(popped.popData<std::string>());
+            }
+        });
+    }
+}
+
+static void addArrayBenchmarks(Bench& bench)
+{
+    for (size_t length : ARRAY_SIZES) {
+        std::vector<int> vector(length, 7);
+        bas::SerializedObject popped;
+        std::string suffix = "/" + std::to_string(length);
+
+        popped.pushData(vector);
+        bench.add("push/vector<int>" + suffix, popped.size(), [vector](size_t iterations) {
+            for (size_t i = 0; i < iterations; i++) {
+                bas::SerializedObject obj;
+                obj.pushData(vector);
+                doNotOptimize(obj.payload());
+            }
+        });
+        bench.add("pop/vector<int>" + suffix, popped.size(), [popped](size_t iterations) mutable {
+            for (size_t i = 0; i < iterations; i++) {
+                popped.rewind();
+                doNotOptimize(popped.popData<std::vector<int>>());
+            }
+        });
+        bench.add("popDataArray<int>" + suffix, popped.size(), [popped](size_t iterations) mutable {
+            for (size_t i = 0; i < iterations; i++) {
+                popped.rewind();
+                doNotOptimize(popped.popDataArray<int>().get());
+            }
+        });
+        bench.add("popDataSpan<int>" + suffix, popped.size(), [popped](size_t iterations) mutable {
+            for (size_t i = 0; i < iterations; i++) {
+                popped.rewind();
+                doNotOptimize(popped.popDataSpan<int>().get());
+            }
+        });
+        bas::BasicSerializedObject<BigEndianLayout> swapped;
+
+        swapped.pushData(vector);
+        bench.add("push/vector<int>-big-endian" + suffix, swapped.size(), [vector](size_t iterations) {
+            for (size_t i = 0; i < iterations; i++) {
+                bas::BasicSerializedObject<BigEndianLayout> obj;
+                obj.pushData(vector);
+                doNotOptimize(obj.payload());
+            }
+        });
+        bench.add("pop/vector<int>-big-endian" + suffix, swapped.size(), [swapped](size_t iterations) mutable {
+            for (size_t i = 0; i < iterations; i++) {
+                swapped.rewind();
+                doNotOptimize(swapped.popData<std::vector<int>>());
+            }
+        });
+        bench.add("pushDataRef/vector<int>" + suffix, popped.size(), [vector](size_t iterations) {
+            bas::IoSegment segments[2];
+
+            for (size_t i = 0; i < iterations; i++) {
+                bas::SerializedObject obj;
+                obj.pushDataRef(vector);
+                doNotOptimize(obj.gather(segments));
+            }
+        });
+    }
+}
+
+static void addNestedBenchmarks(Bench& bench)
+{
+    for (size_t length : NESTED_SIZES) {
+        bas::SerializedObject child;
+        bas::SerializedObject popped;
+        std::string suffix = "/" + std::to_string(length);
+
+        child.pushData(std::vector<int>(length, 7));
+        popped.pushData(child);
+        bench.add("push/nested" + suffix, popped.size(), [child](size_t iterations) {
+            for (size_t i = 0; i < iterations; i++) {
+                bas::SerializedObject obj;
+                obj.pushData(child);
+                doNotOptimize(obj.payload());
+            }
+        });
+        bench.add("pop/nested" + suffix, popped.size(), [popped](size_t iterations) mutable {
+            for (size_t i = 0; i < iterations; i++) {
+                popped.rewind();
+                doNotOptimize(popped.popData<bas::SerializedObject>().payload());
+            }
+        });
+        bench.add("pop/nested-view" + suffix, popped.size(), [popped](size_t iterations) mutable {
+            for (size_t i = 0; i < iterations; i++) {
+                popped.rewind();
+                doNotOptimize(popped.popData<bas::SerializedView>().payload());
+            }
+        });
+    }
+}
+
+static void addSerializableBenchmarks(Bench& bench)
+{
+    for (size_t length : NESTED_SIZES) {
+        SerializablePerson person("David", 32, { std::vector<int>(length, 5), "David" });
+        bas::SerializedObject serialized = person.serialize();
+        std::string suffix = "/" + std::to_string(length);
+
+        bench.add("serialize/person" + suffix, serialized.size(), [person](size_t iterations) mutable {
+            for (size_t i = 0; i < iterations; i++)
+                doNotOptimize(person.serialize().payload());
+        });
+        bench.add("serialize/person-sized" + suffix, serialized.size(), [person](size_t iterations) mutable {
+            for (size_t i = 0; i < iterations; i++)
+                doNotOptimize(person.serialize(bas::sizing).payload());
+        });
+        bench.add("unserialize/person" + suffix, serialized.size(), [serialized](size_t iterations) mutable {
+            SerializablePerson target("", 0, { {}, "" });
+
+            for (size_t i = 0; i < iterations; i++) {
+                target.unserialize(serialized);
+                doNotOptimize(target.age);
+            }
+        });
+        bench.add("roundtrip/person" + suffix, serialized.size(), [person](size_t iterations) mutable {
+            SerializablePerson target("", 0, { {}, "" });
+
+            for (size_t i = 0; i < iterations; i++) {
+                target.unserialize(person.serialize());
+                doNotOptimize(target.age);
+            }
+        });
+
+        InPlacePerson inPlace("David", 32, { std::vector<int>(length, 5), "David" });
+
+        bench.add("serialize/person-in-place" + suffix, serialized.size(), [inPlace](size_t iterations) mutable {
+            for (size_t i = 0; i < iterations; i++)
+                doNotOptimize(inPlace.serialize().payload());
+        });
+        bench.add("serialize/person-in-place-pooled" + suffix, serialized.size(), [inPlace](size_t iterations) mutable {
+            bas::ObjectPool pool;
+
+            for (size_t i = 0; i < iterations; i++) {
+                bas::SerializedObject obj = pool.acquire();
+
+                inPlace.serialize(obj);
+                doNotOptimize(obj.payload());
+                pool.release(std::move(obj));
+            }
+        });
+        bench.add("unserialize/person-in-place" + suffix, serialized.size(), [serialized = inPlace.serialize()](size_t iterations) mutable {
+            InPlacePerson target("", 0, { {}, "" });
+
+            for (size_t i = 0; i < iterations; i++) {
+                target.unserialize(serialized);
+                doNotOptimize(target.age);
+            }
+        });
+    }
+}
+
+static void addReflectableBenchmarks(Bench& bench)
+{
+    for (size_t length : NESTED_SIZES) {
+        ReflectablePerson person;
+        std::string suffix = "/" + std::to_string(length);
+
+        person.name = "David";
+        person.age = 32;
+        person.wallet.money.assign(length, 5);
+        person.wallet.id_card = "David";
+
+        bas::SerializedObject serialized = person.serialize();
+
+        bench.add("serialize/reflectable-person" + suffix, serialized.size(), [person](size_t iterations) {
+            for (size_t i = 0; i < iterations; i++)
+                doNotOptimize(person.serialize().payload());
+        });
+        bench.add("unserialize/reflectable-person" + suffix, serialized.size(), [serialized](size_t iterations) {
+            ReflectablePerson target;
+
+            for (size_t i = 0; i < iterations; i++) {
+                target.unserialize(serialized);
+                doNotOptimize(target.age);
+            }
+        });
+    }
+}
+
+static const size_t BATCH_SIZES[] = { 64, 4096, 262144 };
+
+static void addBatchBenchmarks(Bench& bench)
+{
+    for (size_t count : BATCH_SIZES) {
+        std::vector<ReflectablePerson> people(count);
+        bas::BatchWriter writer;
+        std::string suffix = "/" + std::to_string(count);
+
+        for (ReflectablePerson& person : people) {
+            person.name = "David";
+            person.age = 32;
+            person.wallet.money.assign(16, 5);
+            person.wallet.id_card = "David";
+            writer.push(person);
+        }
+
+        bas::SerializedObject batch = writer.finish();
+
+        bench.add("serialize/records" + suffix, batch.size(), [people](size_t iterations) {
+            for (size_t i = 0; i < iterations; i++) {
+                for (const ReflectablePerson& person : people)
+                    doNotOptimize(person.serialize().payload());
+            }
+        });
+        bench.add("serialize/batch" + suffix, batch.size(), [people](size_t iterations) {
+            bas::BatchWriter writer;
+
+            for (size_t i = 0; i < iterations; i++) {
+                for (const ReflectablePerson& person : people)
+                    writer.push(person);
+                doNotOptimize(writer.finish().payload());
+            }
+        });
+        bench.add("unserialize/batch" + suffix, batch.size(), [batch](size_t iterations) {
+            ReflectablePerson target;
+
+            for (size_t i = 0; i < iterations; i++) {
+                bas::BatchReader reader(batch);
+
+                for (size_t j = 0; j < reader.size(); j++)
+                    target.unserialize(reader[j]);
+                doNotOptimize(target.age);
+            }
+        });
+        bench.add("serialize/batch-parallel" + suffix, batch.size(), [people](size_t iterations) {
+            bas::BatchWriter writer;
+
+            for (size_t i = 0; i < iterations; i++) {
+                writer.pushParallel(people.begin(), people.end());
+                doNotOptimize(writer.finish().payload());
+            }
+        });
+        bench.add("unserialize/batch-parallel" + suffix, batch.size(), [batch, count](size_t iterations) {
+            std::vector<ReflectablePerson> targets(count);
+
+            for (size_t i = 0; i < iterations; i++) {
+                bas::BatchReader reader(batch);
+
+                reader.forEachParallel([&](size_t index, bas::SerializedView record) { targets[index].unserialize(record); });
+                doNotOptimize(targets.back().age);
+            }
+        });
+        bench.add("batch-random-access" + suffix, batch.size() / count, [batch](size_t iterations) {
+            bas::BatchReader reader(batch);
+            ReflectablePerson target;
+            size_t index = 0;
+
+            for (size_t i = 0; i < iterations; i++) {
+                index = (index * 1103515245 + 12345) % reader.size();
+                target.unserialize(reader[index]);
+                doNotOptimize(target.age);
+            }
+        });
+    }
+}
+
+#ifdef _BAS_HAS_MMAP_
+// Removes the file at path when the benchmarks are done with it
+struct TemporaryFile {
+    ~TemporaryFile()
+    {
+        std::error_code error;
+
+        std::filesystem::remove(path, error);
+    }
+
+    std::string path;
+};
+
+static void addArchiveBenchmarks(Bench& bench, const std::string& path)
+{
+    size_t size = 0;
+
+    {
+        bas::ArchiveWriter writer(path, 1 << 20);
+        ReflectablePerson person;
+
+        person.name = "David";
+        person.age = 32;
+        person.wallet.money.assign(16, 5);
+        person.wallet.id_card = "David";
+        for (size_t i = 0; i < 65536; i++)
+            writer.push(person);
+    }
+    size = std::filesystem::file_size(path);
+
+    bench.add("archive/open+unserialize", size, [path](size_t iterations) {
+        ReflectablePerson target;
+
+        for (size_t i = 0; i < iterations; i++) {
+            bas::ArchiveReader reader(path);
+
+            for (size_t j = 0; j < reader.size(); j++)
+                target.unserialize(reader[j]);
+            doNotOptimize(target.age);
+        }
+    });
+}
+#endif
+
+static const size_t CHUNK_SIZES[] = { 1448, 65536 }; // TCP segment payload, socket buffer
+
+static void addFramerBenchmarks(Bench& bench)
+{
+    std::string stream;
+
+    for (size_t i = 0; i < 1024; i++) {
+        bas::SerializedObject obj;
+
+        obj.pushData(i);
+        obj.pushData(std::string(16 + i % 256, 'x'));
+        stream.append(obj.payload(), obj.size());
+    }
+    for (size_t chunkSize : CHUNK_SIZES) {
+        std::string suffix = "/" + std::to_string(chunkSize);
+
+        bench.add("framer/view" + suffix, stream.size(), [stream, chunkSize](size_t iterations) {
+            bas::StreamFramer framer;
+            bas::SerializedView frame;
+
+            for (size_t i = 0; i < iterations; i++) {
+                for (size_t offset = 0; offset < stream.size(); offset += chunkSize) {
+                    framer.feed(stream.data() + offset, std::min(chunkSize, stream.size() - offset));
+                    while (framer.next(frame))
+                        doNotOptimize(frame.payload());
+                }
+            }
+        });
+        bench.add("framer/object" + suffix, stream.size(), [stream, chunkSize](size_t iterations) {
+            bas::StreamFramer framer;
+            bas::SerializedObject frame;
+
+            for (size_t i = 0; i < iterations; i++) {
+                for (size_t offset = 0; offset < stream.size(); offset += chunkSize) {
+                    framer.feed(stream.data() + offset, std::min(chunkSize, stream.size() - offset));
+                    while (framer.next(frame))
+                        doNotOptimize(frame.payload());
+                }
+            }
+        });
+    }
+}
+
+static const size_t INTEGRITY_SIZES[] = { 1024, 65536 };
+
+// The same payloads with and without CRC, to compare the cost of the integrity check
+static void addIntegrityBenchmarks(Bench& bench)
+{
+    for (size_t length : INTEGRITY_SIZES) {
+        std::string data(length, 'x');
+        std::vector<int> vector(length / sizeof(int), 7);
+        std::string suffix = "/" + std::to_string(length);
+        bas::SerializedObject plain;
+        bas::BasicSerializedObject<Crc32cLayout> checked;
+
+        bench.add("crc32c" + suffix, length, [data](size_t iterations) {
+            for (size_t i = 0; i < iterations; i++)
+                doNotOptimize(bas::Crc32c::compute(data.data(), data.size()));
+        });
+        bench.add("crc32c-software" + suffix, length, [data](size_t iterations) {
+            for (size_t i = 0; i < iterations; i++)
+                doNotOptimize(bas::Crc32c::software(data.data(), data.size(), 0));
+        });
+        plain.pushData(vector);
+        checked.pushData(vector);
+        bench.add("push/vector<int>-crc32c" + suffix, checked.size(), [vector](size_t iterations) {
+            for (size_t i = 0; i < iterations; i++) {
+                bas::BasicSerializedObject<Crc32cLayout> obj;
+                obj.pushData(vector);
+                doNotOptimize(obj.payload());
+            }
+        });
+        bench.add("receive/view" + suffix, plain.size(), [plain](size_t iterations) {
+            for (size_t i = 0; i < iterations; i++) {
+                bas::SerializedView view(plain.payload());
+                doNotOptimize(view.popDataSpan<int>().get());
+            }
+        });
+        bench.add("receive/view-crc32c" + suffix, checked.size(), [checked](size_t iterations) {
+            for (size_t i = 0; i < iterations; i++) {
+                bas::BasicSerializedView<Crc32cLayout> view(checked.payload());
+                doNotOptimize(view.popDataSpan<int>().get());
+            }
+        });
+    }
+}
+
+static const size_t COMPRESSION_SIZES[] = { 1024, 8192 }; // Encoded arrays must fit in _BAS_ARRAY_SIZE_
+
+// Slowly varying integers, as sampled by sensors, pushed with each codec
+static void addCompressionBenchmarks(Bench& bench)
+{
+    static const std::pair<bas::Codec, const char*> CODECS[] = {
+        { bas::Codec::None, "none" }, { bas::Codec::Delta, "delta" }, { bas::Codec::Rle, "rle" }, { bas::Codec::Lz, "lz" }
+    };
+
+    for (size_t length : COMPRESSION_SIZES) {
+        std::vector<int> vector(length);
+        std::string suffix = "/" + std::to_string(length);
+
+        for (size_t i = 0; i < length; i++)
+            vector[i] = int(1000 + i / 8 + i % 3);
+        for (const auto& codec : CODECS) {
+            bas::SerializedObject popped;
+
+            popped.pushDataEncoded(vector, codec.first);
+            bench.add(std::string("pushDataEncoded/") + codec.second + suffix, length * sizeof(int), [vector, codec](size_t iterations) {
+                for (size_t i = 0; i < iterations; i++) {
+                    bas::SerializedObject obj;
+                    obj.pushDataEncoded(vector, codec.first);
+                    doNotOptimize(obj.payload());
+                }
+            });
+            bench.add(std::string("popDataEncoded/") + codec.second + suffix, length * sizeof(int), [popped](size_t iterations) mutable {
+                for (size_t i = 0; i < iterations; i++) {
+                    popped.rewind();
+                    doNotOptimize(popped.popDataEncoded<int>());
+                }
+            });
+        }
+        for (const auto& codec : CODECS) {
+            if (codec.first == bas::Codec::Delta)
+                continue;
+            bas::SerializedObject obj;
+            bas::Compressor compressor(codec.first);
+
+            for (size_t i = 0; i < length; i += 1024)
+                obj.pushData(std::vector<int>(vector.begin() + i, vector.begin() + std::min(length, i + 1024)));
+            bas::SerializedObject compressed = compressor.compress(obj);
+
+            bench.add(std::string("compress/") + codec.second + suffix, obj.size(), [obj, compressor](size_t iterations) mutable {
+                bas::SerializedObject compressed;
+
+                for (size_t i = 0; i < iterations; i++) {
+                    compressor.compress(obj.payload(), obj.size(), compressed);
+                    doNotOptimize(compressed.payload());
+                }
+            });
+            bench.add(std::string("decompress/") + codec.second + suffix, obj.size(), [compressed, compressor](size_t iterations) mutable {
+                bas::SerializedObject decompressed;
+
+                for (size_t i = 0; i < iterations; i++) {
+                    compressor.decompress(compressed.payload(), compressed.size(), decompressed);
+                    doNotOptimize(decompressed.payload());
+                }
+            });
+        }
+    }
+}
+
+static const size_t QUEUE_BATCH = 64;
+
+// Frames handed through each queue in batches of QUEUE_BATCH, against a mutex guarded deque
+template <typename Queue>
+static void addQueueBenchmark(Bench& bench, const std::string& name, const bas::SerializedObject& frame)
+{
+    bench.add("queue/" + name, frame.size() * QUEUE_BATCH, [frame](size_t iterations) {
+        Queue queue(QUEUE_BATCH);
+        bas::SerializedObject popped[QUEUE_BATCH];
+
+        for (size_t i = 0; i < iterations; i++) {
+            for (size_t j = 0; j < QUEUE_BATCH; j++)
+                queue.tryPush(bas::SerializedObject(frame));
+            doNotOptimize(queue.tryPop(popped, QUEUE_BATCH));
+        }
+    });
+    bench.add("queue/" + name + "-threads", frame.size() * QUEUE_BATCH, [frame](size_t iterations) {
+        Queue queue(QUEUE_BATCH * 4);
+        bas::SerializedObject popped[QUEUE_BATCH];
+        std::thread producer([&queue, &frame, iterations]() {
+            for (size_t i = 0; i < iterations * QUEUE_BATCH; i++) {
+                bas::SerializedObject obj(frame);
+
+                while (!queue.tryPush(std::move(obj)))
+                    std::this_thread::yield();
+            }
+        });
+
+        for (size_t received = 0; received < iterations * QUEUE_BATCH;) {
+            size_t count = queue.tryPop(popped, QUEUE_BATCH);
+
+            if (count == 0)
+                std::this_thread::yield();
+            received += count;
+        }
+        producer.join();
+    });
+}
+
+static void addQueueBenchmarks(Bench& bench)
+{
+    bas::SerializedObject frame;
+
+    frame.pushData(std::string(256, 'x'));
+    bench.add("queue/mutex-deque", frame.size() * QUEUE_BATCH, [frame](size_t iterations) {
+        std::mutex mutex;
+        std::deque<bas::SerializedObject> queue;
+        bas::SerializedObject popped[QUEUE_BATCH];
+
+        for (size_t i = 0; i < iterations; i++) {
+            for (size_t j = 0; j < QUEUE_BATCH; j++) {
+                std::lock_guard<std::mutex> lock(mutex);
+                queue.push_back(frame);
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            for (size_t j = 0; j < QUEUE_BATCH; j++) {
+                popped[j] = std::move(queue.front());
+                queue.pop_front();
+            }
+        }
+    });
+    addQueueBenchmark<bas::SpscQueue>(bench, "spsc", frame);
+    addQueueBenchmark<bas::MpscQueue>(bench, "mpsc", frame);
+}
+
+static const size_t INDEX_FIELDS = 64;
+static const size_t INDEX_TARGET = 48;
+
+// Reading one field deep into a message: popping the fields before it, walking their metadata, or reading the trailer
+static void addFieldIndexBenchmarks(Bench& bench)
+{
+    bas::SerializedObject obj;
+
+    for (size_t i = 0; i < INDEX_FIELDS; i++) {
+        if (i == INDEX_TARGET)
+            obj.pushData(int64_t(i));
+        else
+            obj.pushData(std::string(16 + i % 7, 'x'));
+    }
+    bas::SerializedObject indexed(obj);
+
+    bas::FieldIndex::pushTrailer(indexed);
+    bench.add("index/pop-sequential", obj.size(), [obj](size_t iterations) mutable {
+        for (size_t i = 0; i < iterations; i++) {
+            obj.rewind();
+            for (size_t j = 0; j < INDEX_TARGET; j++)
+                doNotOptimize(obj.popData<std::string>());
+            doNotOptimize(obj.popData<int64_t>());
+        }
+    });
+    bench.add("index/walk", obj.size(), [obj](size_t iterations) {
+        bas::FieldIndex index(obj);
+
+        for (size_t i = 0; i < iterations; i++) {
+            index.assign(obj.payload(), obj.size());
+            doNotOptimize(index.get<int64_t>(INDEX_TARGET));
+        }
+    });
+    bench.add("index/trailer", indexed.size(), [indexed](size_t iterations) {
+        bas::FieldIndex index(indexed);
+
+        for (size_t i = 0; i < iterations; i++) {
+            index.assign(indexed.payload(), indexed.size());
+            doNotOptimize(index.get<int64_t>(INDEX_TARGET));
+        }
+    });
+}
+
+////////////////////////////////////////////
+
+static void printTable(const std::vector<Result>& results)
+{
+    std::printf("%-36s %10s %12s %14s %12s %14s\n", "benchmark", "bytes", "iterations", "ns/op", "MB/s", "allocs/op");
+    for (const Result& result : results) {
+        double throughput = result.bytes * 1e3 / result.nsPerOp;
+
+        std::printf("%-36s %10zu %12zu %14.2f %12.1f %14.2f\n", result.name.c_str(), result.bytes,
+            result.iterations, result.nsPerOp, throughput, result.allocsPerOp);
+    }
+}
+
+static void printCsv(const std::vector<Result>& results)
+{
+    std::printf("benchmark,bytes,iterations,ns_per_op,bytes_per_second,allocs_per_op\n");
+    for (const Result& result : results) {
+        std::printf("%s,%zu,%zu,%.3f,%.0f,%.3f\n", result.name.c_str(), result.bytes, result.iterations,
+            result.nsPerOp, result.bytes * 1e9 / result.nsPerOp, result.allocsPerOp);
+    }
+}
+
+static void printJson(const std::vector<Result>& results)
+{
+    std::printf("[\n");
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result& result = results[i];
+
+        std::printf("  {\"benchmark\": \"%s\", \"bytes\": %zu, \"iterations\": %zu, \"ns_per_op\": %.3f, "
+                    "\"bytes_per_second\": %.0f, \"allocs_per_op\": %.3f}%s\n",
+            result.name.c_str(), result.bytes, result.iterations, result.nsPerOp,
+            result.bytes * 1e9 / result.nsPerOp, result.allocsPerOp, i + 1 < results.size() ? "," : "");
+    }
+    std::printf("]\n");
+}
+
+int main(int ac, char** av)
+{
+    std::string filter;
+    double minTime = 0.2;
+    void (*print)(const std::vector<Result>&) = printTable;
+    Bench bench;
+
+    for (int i = 1; i < ac; i++) {
+        std::string arg = av[i];
+
+        if (arg.rfind("--filter=", 0) == 0) {
+            filter = arg.substr(9);
+        } else if (arg.rfind("--min-time=", 0) == 0) {
+            minTime = std::atof(arg.c_str() + 11);
+        } else if (arg == "--json") {
+            print = printJson;
+        } else if (arg == "--csv") {
+            print = printCsv;
+        } else {
+            std::fprintf(stderr, "Usage: %s [--filter=substring] [--min-time=seconds] [--json | --csv]\n", av[0]);
+            return 1;
+        }
+    }
+
+    addScalarBenchmarks(bench);
+    addStringBenchmarks(bench);
+    addArrayBenchmarks(bench);
+    addNestedBenchmarks(bench);
+    addSerializableBenchmarks(bench);
+    addReflectableBenchmarks(bench);
+    addBatchBenchmarks(bench);
+    addFramerBenchmarks(bench);
+    addIntegrityBenchmarks(bench);
+    addCompressionBenchmarks(bench);
+    addQueueBenchmarks(bench);
+    addFieldIndexBenchmarks(bench);
+#ifdef _BAS_HAS_MMAP_
+    TemporaryFile archive { (std::filesystem::temp_directory_path() / "bas_bench.archive").string() };
+
+    addArchiveBenchmarks(bench, archive.path);
+#endif
+
+    print(bench.run(filter, minTime));
+    return 0;
+}
@@ -0,0 +1,41 @@
+/*
+** ByteArraySerialisation
+** File description:
+** Reflection example
+*/
+
+#include "bas.hpp"
+
+#include <string>
+
+class ReflectablePerson : public bas::Reflectable<ReflectablePerson> {   // inherit from the Reflectable class, with your class as parameter
+public:
+    ReflectablePerson(const std::string& name, int age)
+        : name(name)
+        , age(age)
+    {
+    }
+
+    ~ReflectablePerson() = default;
+
+    BAS_FIELDS(name, age)                                                  // no makeSerialization nor makeUnserialization needed, the fields are listed once
+
+    std::string name;
+    int age;
+};
+
+int main(void)
+{
+    ReflectablePerson person1("David", 32);
+    ReflectablePerson person2("Robert", 45);
+
+    bas::SerializedObject obj;
+
+    obj = person1.serialize();
+
+    person2.unserialize(obj);
+
+    // person2 is now a copy of person1
+
+    return 0;
+}
@@ -19,17 +19,100 @@
     avoid code duplication and make the addition of specialised function template easier.
     - Added documentation of the library, generated by doxygen.
     - Changed vector assign on constructFromPayload, size was size + _BAS_CHECKSUM_SIZE_, which was too long
+    - Popping now moves a read cursor instead of erasing the front of the payload, which made
+    unserialization quadratic. Added rewind() and unserialize() no longer copies the SerializedObject.
+    - pushData now appends each data with a single copy instead of byte by byte. Added reserve() and capacity().
+    - The checksum is now written once when the payload is retrieved instead of after every pushData.
+    Added finalize(), after which the const functions of a SerializedObject no longer modify it.
+    - Added move constructor and move assignment to SerializedObject, popping a SerializedObject no longer goes through a temporary buffer.
+    - Added SerializedView, to pop data from a payload without copying it.
+    - Added popDataSpan() and popData<std::string_view>() which point directly into the payload. Popping
+    std::string and std::vector now copies the data only once. The lib now requires C++17.
+    - SerializedObject can allocate its payload from any std::pmr::memory_resource. Added the Arena memory resource.
+    Breaking: vector() returned a std::pmr::vector<char>& instead of a std::vector<char>&, until the Buffer below replaced it.
+    - Payloads smaller than _BAS_INLINE_CAPACITY_ are stored inside the SerializedObject, without allocation.
+    Breaking: vector() returns the Buffer holding the payload instead of a std::vector<char>&, which is a source break.
+    It is deprecated in favor of buffer().
+    - Added Reflectable and BAS_FIELDS(), which generate the serialization of a class from the list of its fields.
+    - Added serializedSize() and sizing SerializedObjects, serialize(bas::sizing) allocates the payload once.
+    - Added the _BAS_VARINT_SIZES_ option, to store sizes as varints.
+    - SerializedObject and SerializedView are now BasicSerializedObject and BasicSerializedView with the default
+    layout. The layout of the payload (FixedLayout, VarintLayout) is a template parameter, the _BAS_* macros only
+    configure DefaultLayout.
+    - Added pushObject() and popObject() to nest objects in place, and popData<SerializedView>() to pop a nested
+    payload without copying it. Reflectable nests its Reflectable fields in place.
+    - Added StreamFramer to cut payloads out of a stream received in chunks. Popping past the end of a payload
+    and out of bounds sizes now throw PayloadError, and constructing from a payload no longer prints its size.
+    - Added BatchWriter and BatchReader to store many records in a single payload with an offset table.
+    - Added pushDataRef() to push arrays by reference and gather() to send the payload with writev() without copying them.
+    - Added ArchiveWriter and ArchiveReader to store records in a file and pop them from a memory mapping.
+    The batch size of the ArchiveWriter must fit the length of the layout.
+    - Added BatchWriter::pushParallel() and BatchReader::forEachParallel() to serialize and unserialize batches on several threads.
+    - Added the Endian parameter of the layouts and _BAS_ENDIAN_, to store pushed numbers in a fixed byte order.
+    The SIMD byte-swap kernels are chosen at runtime on x86.
+    - Added Crc32cLayout and _BAS_CRC32C_, to check the integrity of received payloads with a hardware accelerated CRC32C.
+    - Added pushDataEncoded() and popDataEncoded() to push arrays with delta, run-length or LZ encoding,
+    and Compressor to compress whole payloads and report the compression ratio and throughput.
+    - Added SpscQueue and MpscQueue, lock-free rings moving SerializedObjects from producer threads to a consumer thread.
+    - clear() now leaves an empty payload ready to be pushed into instead of no payload at all. Added ObjectPool
+    to recycle SerializedObjects across threads, and serialize(SerializedObject&) to serialize into a recycled object.
+    - Added FieldIndex to pop any field of a payload without popping the fields before it, and its optional trailer.
 */
 
 #ifndef BAS_HPP_
 #define BAS_HPP_
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
 #include <cstring>
+#include <exception>
+#include <limits>
 #include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
 #include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
-#include <iostream>
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#if defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define _BAS_SIMD_DISPATCH_ 1 // The SIMD kernels are compiled for their instruction set and chosen at runtime
+#define _BAS_TARGET_(isa) __attribute__((target(isa)))
+#else
+#define _BAS_TARGET_(isa)
+#endif
+
+#if __has_include(<sys/uio.h>)
+#include <sys/uio.h>
+#define _BAS_HAS_IOVEC_ 1
+#endif
+
+#if __has_include(<sys/mman.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define _BAS_HAS_MMAP_ 1
+#endif
 
 ////////////////////////////////////////////
 
@@ -37,371 +120,4632 @@
 #define _BAS_ARRAY_SIZE_ 2    // MAX is your OS size_t byte size (4 is max recommended as it will be compatible in most cases)
 #define _BAS_CHECKSUM_SIZE_ 4 // If this lib is used for networking, make sure that these 3 numbers are the same on both ends
 
-////////////////////////////////////////////
+#define _BAS_ENDIAN_ 0 // Byte order of the numbers in the payload: 0 is the order of the host, 1 is little-endian and 2 is big-endian.
+                       // Set to 1 or 2 if both ends may not have the same byte order
+
+#define _BAS_CRC32C_ 0 // Set to 1 to store a CRC32C of the payload after the checksum, verified when a payload is received.
+                       // Must be the same on both ends as well
+
+#define _BAS_VARINT_SIZES_ 0  // Set to 1 to store var size and array size as LEB128 varints instead of _BAS_SIZE_BYTES_ and _BAS_ARRAY_SIZE_ Bytes,
+                              // small data gets smaller metadata and sizes are not limited anymore. Must be the same on both ends as well
+
+#define _BAS_INLINE_CAPACITY_ 64 // Payloads up to this size (in Bytes) are stored inside the SerializedObject without allocation
+
+#define _BAS_MAX_FRAME_SIZE_ 16777216 // Default maximum size (in Bytes) of a payload received by a StreamFramer
+
+////////////////////////////////////////////
+
+namespace bas {
+
+template <typename T>
+class Helper;
+
+template <typename T>
+class PoppedArray;
+
+template <typename T>
+class PoppedSpan;
+
+template <typename Derived>
+class Reflectable;
+
+/**
+ * @brief Byte order of the numbers pushed into a payload.
+ * 
+ * The metadata of a payload is always little-endian, the byte order only applies to the pushed data.
+ * Only arithmetic and enum types of 2, 4 or 8 Bytes, alone or in arrays, are converted.
+ */
+enum class Endian {
+    Native, ///< The byte order of the host, nothing is converted
+    Little,
+    Big,
+};
+
+/**
+ * @brief Encoding of a compressed array or payload.
+ * @see SerializedObject::pushDataEncoded(), BasicCompressor
+ */
+enum class Codec : uint8_t {
+    None = 0, ///< Stored as is
+    Delta = 1, ///< Differences between consecutive integers, as zigzag varints. Only for arrays of integers
+    Rle = 2, ///< Runs of equal elements, as their count followed by the element
+    Lz = 3, ///< LZ77 block, sequences of Bytes repeated within 64KB are replaced by a reference to their previous occurrence
+};
+
+/// \cond
+/**
+ * Reads and writes the numbers stored in the metadata of a payload, used by the layouts.
+ */
+struct Wire {
+    static constexpr size_t MAX_VARINT_LENGTH = (sizeof(size_t) * 8 + 6) / 7;
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    static constexpr bool IS_LITTLE_ENDIAN = false;
+#else
+    static constexpr bool IS_LITTLE_ENDIAN = true;
+#endif
+
+    template <typename T>
+    static constexpr bool isSwappable = (std::is_arithmetic_v<T> || std::is_enum_v<T>) && (sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8);
+
+    static constexpr size_t varintLength(size_t number)
+    {
+        size_t length = 1;
+
+        for (; number >= 0x80; number >>= 7)
+            length++;
+        return length;
+    }
+
+    static inline size_t writeVarint(char* data, size_t number)
+    {
+        size_t length = 0;
+
+        for (; number >= 0x80; number >>= 7)
+            data[length++] = (number & 0x7F) | 0x80;
+        data[length++] = number;
+        return length;
+    }
+
+    /**
+     * Writes number on exactly length Bytes, padding it with continuation Bytes.
+     */
+    static inline void writePaddedVarint(char* data, size_t number, size_t length)
+    {
+        for (size_t i = 0; i + 1 < length; i++, number >>= 7)
+            data[i] = (number & 0x7F) | 0x80;
+        data[length - 1] = number & 0x7F;
+    }
+
+    static inline size_t readVarint(const char* data, size_t& number)
+    {
+        const unsigned char* data_ = (const unsigned char*)data;
+        size_t length = 0;
+
+        number = 0;
+        do {
+            number |= static_cast<size_t>(data_[length] & 0x7F) << (length * 7);
+        } while (data_[length++] & 0x80 && length < MAX_VARINT_LENGTH);
+        return length;
+    }
+
+    static inline size_t readNumber(const char* data, size_t bytes)
+    {
+        const unsigned char* data_ = (const unsigned char*)data;
+        size_t number = 0;
+
+        for (size_t i = 0; i < bytes; i++)
+            number |= (static_cast<size_t>(data_[i]) << (i * 8));
+        return number;
+    }
+
+    static inline void writeNumber(char* data, size_t bytes, size_t number)
+    {
+        for (size_t i = 0; i < bytes; i++)
+            data[i] = (number >> (i * 8)) & 0xFF;
+    }
+
+    /**
+     * Fixed-width variants of readNumber() and writeNumber(), unrolled at compile time.
+     */
+    template <size_t Bytes>
+    static inline size_t load(const char* data)
+    {
+        static_assert(Bytes <= sizeof(size_t), "numbers are at most sizeof(size_t) Bytes");
+        return load((const unsigned char*)data, std::make_index_sequence<Bytes>());
+    }
+
+    template <size_t Bytes>
+    static inline void store(char* data, size_t number)
+    {
+        static_assert(Bytes <= sizeof(size_t), "numbers are at most sizeof(size_t) Bytes");
+        store(data, number, std::make_index_sequence<Bytes>());
+    }
+
+    /**
+     * Returns the biggest number store<Bytes>() can hold.
+     */
+    template <size_t Bytes>
+    static constexpr size_t maxStored(void)
+    {
+        static_assert(Bytes <= sizeof(size_t), "numbers are at most sizeof(size_t) Bytes");
+        return Bytes == sizeof(size_t) ? std::numeric_limits<size_t>::max() : (size_t(1) << (8 * (Bytes % sizeof(size_t)))) - 1;
+    }
+
+    /**
+     * Copies count numbers of Bytes Bytes from src to dst, reversing the Bytes of each number.
+     * Whole vectors of numbers are swapped with a single shuffle on CPUs with SSSE3, AVX2 or NEON.
+     * With GCC and Clang on x86, the kernel is chosen at runtime, without -mssse3 or -mavx2.
+     * src and dst may be the same.
+     */
+    template <size_t Bytes>
+    static inline void swapBytes(char* dst, const char* src, size_t count)
+    {
+        static_assert(Bytes == 2 || Bytes == 4 || Bytes == 8, "only numbers of 2, 4 or 8 Bytes are swapped");
+        size_t i = 0;
+
+#if defined(__AVX2__)
+        i = swapAvx2<Bytes>(dst, src, count);
+#elif defined(_BAS_SIMD_DISPATCH_)
+        static const int simd = __builtin_cpu_supports("avx2") ? 2 : __builtin_cpu_supports("ssse3") ? 1 : 0;
+
+        if (simd == 2)
+            i = swapAvx2<Bytes>(dst, src, count);
+        else if (simd == 1)
+            i = swapSsse3<Bytes>(dst, src, count);
+#elif defined(__SSSE3__)
+        i = swapSsse3<Bytes>(dst, src, count);
+#elif defined(__ARM_NEON)
+        for (; i + 16 / Bytes <= count; i += 16 / Bytes) {
+            uint8x16_t numbers = vld1q_u8((const uint8_t*)src + i * Bytes);
+
+            if constexpr (Bytes == 2)
+                numbers = vrev16q_u8(numbers);
+            else if constexpr (Bytes == 4)
+                numbers = vrev32q_u8(numbers);
+            else
+                numbers = vrev64q_u8(numbers);
+            vst1q_u8((uint8_t*)dst + i * Bytes, numbers);
+        }
+#endif
+        for (; i < count; i++)
+            swapNumber<Bytes>(dst + i * Bytes, src + i * Bytes);
+    }
+
+private:
+#if defined(__AVX2__) || defined(__SSSE3__) || defined(_BAS_SIMD_DISPATCH_)
+    // Index of the Byte each Byte is taken from, within its 16 Bytes lane
+    template <size_t Bytes>
+    static inline void swapMask(char (&mask)[32])
+    {
+        for (size_t j = 0; j < sizeof(mask); j++)
+            mask[j] = static_cast<char>((j / Bytes * Bytes + Bytes - 1 - j % Bytes) & 0x0F);
+    }
+
+    // Swaps the numbers 16 Bytes at a time, and returns the number of swapped numbers
+    template <size_t Bytes>
+    _BAS_TARGET_("ssse3") static inline size_t swapSsse3(char* dst, const char* src, size_t count)
+    {
+        char mask[32];
+        size_t i = 0;
+
+        swapMask<Bytes>(mask);
+        __m128i mask128 = _mm_loadu_si128((const __m128i*)mask);
+
+        for (; i + 16 / Bytes <= count; i += 16 / Bytes) {
+            __m128i numbers = _mm_loadu_si128((const __m128i*)(src + i * Bytes));
+
+            _mm_storeu_si128((__m128i*)(dst + i * Bytes), _mm_shuffle_epi8(numbers, mask128));
+        }
+        return i;
+    }
+
+    // Swaps the numbers 32 Bytes at a time, then 16 Bytes at a time, and returns the number of swapped numbers
+    template <size_t Bytes>
+    _BAS_TARGET_("avx2") static inline size_t swapAvx2(char* dst, const char* src, size_t count)
+    {
+        char mask[32];
+        size_t i = 0;
+
+        swapMask<Bytes>(mask);
+        __m256i mask256 = _mm256_loadu_si256((const __m256i*)mask);
+        __m128i mask128 = _mm_loadu_si128((const __m128i*)mask);
+
+        for (; i + 32 / Bytes <= count; i += 32 / Bytes) {
+            __m256i numbers = _mm256_loadu_si256((const __m256i*)(src + i * Bytes));
+
+            _mm256_storeu_si256((__m256i*)(dst + i * Bytes), _mm256_shuffle_epi8(numbers, mask256));
+        }
+        for (; i + 16 / Bytes <= count; i += 16 / Bytes) {
+            __m128i numbers = _mm_loadu_si128((const __m128i*)(src + i * Bytes));
+
+            _mm_storeu_si128((__m128i*)(dst + i * Bytes), _mm_shuffle_epi8(numbers, mask128));
+        }
+        return i;
+    }
+#endif
+
+    template <size_t Bytes>
+    static inline void swapNumber(char* dst, const char* src)
+    {
+        using Number = std::conditional_t<Bytes == 2, uint16_t, std::conditional_t<Bytes == 4, uint32_t, uint64_t>>;
+        Number number;
+
+        std::memcpy(&number, src, Bytes);
+#if defined(__GNUC__)
+        if constexpr (Bytes == 2)
+            number = __builtin_bswap16(number);
+        else if constexpr (Bytes == 4)
+            number = __builtin_bswap32(number);
+        else
+            number = __builtin_bswap64(number);
+#else
+        Number swapped = 0;
+
+        for (size_t i = 0; i < Bytes; i++, number >>= 8)
+            swapped = (swapped << 8) | (number & 0xFF);
+        number = swapped;
+#endif
+        std::memcpy(dst, &number, Bytes);
+    }
+
+    template <size_t... I>
+    static inline size_t load(const unsigned char* data, std::index_sequence<I...>)
+    {
+        return (size_t(0) | ... | (static_cast<size_t>(data[I]) << (I * 8)));
+    }
+
+    template <size_t... I>
+    static inline void store(char* data, size_t number, std::index_sequence<I...>)
+    {
+        ((data[I] = static_cast<char>(number >> (I * 8))), ...);
+    }
+};
+/// \endcond
+
+/**
+ * @brief Layout of a payload whose var size and array size are stored on a fixed number of Bytes.
+ * 
+ * A layout describes how the metadata of a payload is stored, it is given as template parameter
+ * to BasicSerializedObject and BasicSerializedView. Both ends of a connection must use the same layout.
+ * @tparam SizeBytes Number of Bytes used to store var size.
+ * @tparam ArrayBytes Number of Bytes used to store array size.
+ * @tparam ChecksumBytes Number of Bytes used to store the checksum at the beginning of the payload.
+ * @tparam DataEndian Byte order of the pushed numbers.
+ * @see VarintLayout
+ */
+template <size_t SizeBytes, size_t ArrayBytes, size_t ChecksumBytes, Endian DataEndian = Endian::Native>
+struct FixedLayout {
+    static constexpr size_t CHECKSUM_SIZE = ChecksumBytes;
+    /// Number of Bytes of the offsets and counts stored in batch and index tables.
+    static constexpr size_t LENGTH_SIZE = ChecksumBytes;
+    static constexpr Endian ENDIAN = DataEndian;
+
+    /**
+     * @brief True if the pushed numbers are stored in the reverse byte order of the host.
+     */
+    static constexpr bool SWAP_BYTES = DataEndian != Endian::Native && (DataEndian == Endian::Little) != Wire::IS_LITTLE_ENDIAN;
+    static constexpr bool HAS_CRC = false;
+    static constexpr size_t MAX_SIZES_LENGTH = SizeBytes + ArrayBytes;
+
+    /**
+     * @brief Number of Bytes of metadata stored before a data of array_size elements of size Bytes.
+     */
+    static constexpr size_t sizesLength(size_t, size_t)
+    {
+        return SizeBytes + ArrayBytes;
+    }
+
+    static inline size_t writeSizes(char* data, size_t size, size_t array_size)
+    {
+        Wire::store<SizeBytes>(data, size);
+        Wire::store<ArrayBytes>(data + SizeBytes, array_size);
+        return SizeBytes + ArrayBytes;
+    }
+
+    static inline size_t readSizes(const char* data, size_t& size, size_t& array_size)
+    {
+        size = Wire::load<SizeBytes>(data);
+        array_size = Wire::load<ArrayBytes>(data + SizeBytes);
+        return SizeBytes + ArrayBytes;
+    }
+
+    /**
+     * @brief Number of Bytes of metadata reserved before an object nested in place.
+     * @see BasicSerializedObject::pushObject()
+     */
+    static constexpr size_t NESTED_SIZES_LENGTH = SizeBytes + ArrayBytes;
+
+    /**
+     * @brief Back-patches the metadata of an object of array_size Bytes nested in place.
+     */
+    static inline void writeNestedSizes(char* data, size_t array_size)
+    {
+        writeSizes(data, sizeof(char), array_size);
+    }
+
+    static inline void writeChecksum(char* data, size_t size)
+    {
+        Wire::store<ChecksumBytes>(data, size);
+    }
+
+    static inline size_t readChecksum(const char* data)
+    {
+        return Wire::load<ChecksumBytes>(data);
+    }
+
+    /**
+     * @brief Returns true if the payload of size Bytes at data is intact, always true without Crc32cLayout.
+     */
+    static inline bool verifyChecksum(const char*, size_t)
+    {
+        return true;
+    }
+};
+
+/**
+ * @brief Layout of a payload whose var size and array size are stored as LEB128 varints.
+ * 
+ * Small data gets smaller metadata (2 Bytes for an int), and sizes are not limited.
+ * @tparam ChecksumBytes Number of Bytes used to store the checksum at the beginning of the payload.
+ * @tparam DataEndian Byte order of the pushed numbers.
+ * @see FixedLayout
+ */
+template <size_t ChecksumBytes, Endian DataEndian = Endian::Native>
+struct VarintLayout {
+    static constexpr size_t CHECKSUM_SIZE = ChecksumBytes;
+    /// Number of Bytes of the offsets and counts stored in batch and index tables.
+    static constexpr size_t LENGTH_SIZE = ChecksumBytes;
+    static constexpr Endian ENDIAN = DataEndian;
+
+    /**
+     * @brief True if the pushed numbers are stored in the reverse byte order of the host.
+     */
+    static constexpr bool SWAP_BYTES = DataEndian != Endian::Native && (DataEndian == Endian::Little) != Wire::IS_LITTLE_ENDIAN;
+    static constexpr bool HAS_CRC = false;
+    static constexpr size_t MAX_SIZES_LENGTH = 2 * Wire::MAX_VARINT_LENGTH;
+
+    /**
+     * @brief Number of Bytes of metadata stored before a data of array_size elements of size Bytes.
+     */
+    static constexpr size_t sizesLength(size_t size, size_t array_size)
+    {
+        return Wire::varintLength(size) + Wire::varintLength(array_size);
+    }
+
+    static inline size_t writeSizes(char* data, size_t size, size_t array_size)
+    {
+        size_t length = Wire::writeVarint(data, size);
+
+        return length + Wire::writeVarint(data + length, array_size);
+    }
+
+    static inline size_t readSizes(const char* data, size_t& size, size_t& array_size)
+    {
+        size_t length = Wire::readVarint(data, size);
+
+        return length + Wire::readVarint(data + length, array_size);
+    }
+
+    /**
+     * @brief Number of Bytes of metadata reserved before an object nested in place.
+     * 
+     * Since the size of the object is unknown when the metadata is reserved,
+     * its array size is padded to the length of the biggest varint.
+     * @see BasicSerializedObject::pushObject()
+     */
+    static constexpr size_t NESTED_SIZES_LENGTH = 1 + Wire::MAX_VARINT_LENGTH;
+
+    /**
+     * @brief Back-patches the metadata of an object of array_size Bytes nested in place.
+     */
+    static inline void writeNestedSizes(char* data, size_t array_size)
+    {
+        data[0] = sizeof(char);
+        Wire::writePaddedVarint(data + 1, array_size, Wire::MAX_VARINT_LENGTH);
+    }
+
+    static inline void writeChecksum(char* data, size_t size)
+    {
+        Wire::store<ChecksumBytes>(data, size);
+    }
+
+    static inline size_t readChecksum(const char* data)
+    {
+        return Wire::load<ChecksumBytes>(data);
+    }
+
+    /**
+     * @brief Returns true if the payload of size Bytes at data is intact, always true without Crc32cLayout.
+     */
+    static inline bool verifyChecksum(const char*, size_t)
+    {
+        return true;
+    }
+};
+
+/// \cond
+struct Crc32cTables {
+    uint32_t table[8][256];
+
+    constexpr Crc32cTables()
+        : table()
+    {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t crc = i;
+
+            for (int bit = 0; bit < 8; bit++)
+                crc = crc & 1 ? (crc >> 1) ^ 0x82F63B78 : crc >> 1;
+            table[0][i] = crc;
+        }
+        for (uint32_t i = 0; i < 256; i++)
+            for (int slice = 1; slice < 8; slice++)
+                table[slice][i] = (table[slice - 1][i] >> 8) ^ table[0][table[slice - 1][i] & 0xFF];
+    }
+
+    static const Crc32cTables TABLES;
+};
+
+inline constexpr Crc32cTables Crc32cTables::TABLES {};
+
+/**
+ * CRC32C (Castagnoli), with the SSE 4.2 or ARMv8 CRC instructions when the CPU has them,
+ * and a slicing-by-8 table otherwise.
+ */
+struct Crc32c {
+    static inline uint32_t compute(const char* data, size_t size, uint32_t crc = 0)
+    {
+        crc = ~crc;
+#if defined(__ARM_FEATURE_CRC32) || (defined(__x86_64__) && defined(__SSE4_2__))
+        crc = hardware(data, size, crc);
+#elif defined(__x86_64__) && defined(__GNUC__)
+        static const bool hasHardware = __builtin_cpu_supports("sse4.2");
+
+        crc = hasHardware ? hardware(data, size, crc) : software(data, size, crc);
+#else
+        crc = software(data, size, crc);
+#endif
+        return ~crc;
+    }
+
+    static inline uint32_t software(const char* data, size_t size, uint32_t crc)
+    {
+        const auto& table = Crc32cTables::TABLES.table;
+        const unsigned char* data_ = (const unsigned char*)data;
+
+        for (; size >= 8; size -= 8, data_ += 8) {
+            uint32_t low = crc ^ static_cast<uint32_t>(Wire::load<4>((const char*)data_));
+            uint32_t high = static_cast<uint32_t>(Wire::load<4>((const char*)data_ + 4));
+
+            crc = table[7][low & 0xFF] ^ table[6][(low >> 8) & 0xFF] ^ table[5][(low >> 16) & 0xFF] ^ table[4][low >> 24]
+                ^ table[3][high & 0xFF] ^ table[2][(high >> 8) & 0xFF] ^ table[1][(high >> 16) & 0xFF] ^ table[0][high >> 24];
+        }
+        for (; size > 0; size--, data_++)
+            crc = table[0][(crc ^ *data_) & 0xFF] ^ (crc >> 8);
+        return crc;
+    }
+
+#if defined(__ARM_FEATURE_CRC32)
+    static inline uint32_t hardware(const char* data, size_t size, uint32_t crc)
+    {
+        uint64_t word;
+
+        for (; size >= 8; size -= 8, data += 8) {
+            std::memcpy(&word, data, 8);
+            crc = __crc32cd(crc, word);
+        }
+        for (; size > 0; size--, data++)
+            crc = __crc32cb(crc, *data);
+        return crc;
+    }
+#elif defined(__x86_64__) && defined(__GNUC__)
+    __attribute__((target("sse4.2"))) static inline uint32_t hardware(const char* data, size_t size, uint32_t crc)
+    {
+        uint64_t word;
+
+        for (; size >= 8; size -= 8, data += 8) {
+            std::memcpy(&word, data, 8);
+            crc = static_cast<uint32_t>(_mm_crc32_u64(crc, word));
+        }
+        for (; size > 0; size--, data++)
+            crc = _mm_crc32_u8(crc, *data);
+        return crc;
+    }
+#endif
+};
+/// \endcond
+
+/**
+ * @brief Layout adding a CRC32C of the payload after the checksum of Base.
+ * 
+ * The CRC is computed once, when the payload is finished by payload(), and verified once,
+ * when a payload is received: by the constructors of SerializedObject from a payload, SerializedView(const char*),
+ * BatchReader and ArchiveReader, by the StreamFramer and by Compressor::decompress(), which throw PayloadError if it does not match.
+ * SerializedView(const char*, size_t) and FieldIndex do not verify it, they pop from payloads whose CRC was already verified.
+ * The payloads nested in or batched with a verified payload are covered by its CRC.\n
+ * Arrays pushed by reference are copied, since the CRC is computed over the whole payload.
+ * @tparam Base The layout of the metadata, FixedLayout or VarintLayout.
+ */
+template <typename Base>
+struct Crc32cLayout : Base {
+    static constexpr size_t CHECKSUM_SIZE = Base::CHECKSUM_SIZE + sizeof(uint32_t);
+    static constexpr bool HAS_CRC = true;
+
+    static inline void writeChecksum(char* data, size_t size)
+    {
+        Base::writeChecksum(data, size);
+        Wire::store<sizeof(uint32_t)>(data + Base::CHECKSUM_SIZE, Crc32c::compute(data + CHECKSUM_SIZE, size - CHECKSUM_SIZE));
+    }
+
+    static inline bool verifyChecksum(const char* data, size_t size)
+    {
+        if (size < CHECKSUM_SIZE)
+            return false;
+        return Wire::load<sizeof(uint32_t)>(data + Base::CHECKSUM_SIZE) == Crc32c::compute(data + CHECKSUM_SIZE, size - CHECKSUM_SIZE);
+    }
+};
+
+/// \cond
+template <typename Base, bool Crc>
+using OptionalCrc32cLayout = std::conditional_t<Crc, Crc32cLayout<Base>, Base>;
+/// \endcond
+
+/**
+ * @brief The layout used by SerializedObject and SerializedView, configured by the _BAS_* macros.
+ */
+using DefaultLayout = OptionalCrc32cLayout<std::conditional_t<_BAS_VARINT_SIZES_ != 0,
+    VarintLayout<_BAS_CHECKSUM_SIZE_, static_cast<Endian>(_BAS_ENDIAN_)>,
+    FixedLayout<_BAS_SIZE_BYTES_, _BAS_ARRAY_SIZE_, _BAS_CHECKSUM_SIZE_, static_cast<Endian>(_BAS_ENDIAN_)>>,
+    _BAS_CRC32C_ != 0>;
+
+template <typename Layout = DefaultLayout>
+class BasicSerializedObject;
+
+template <typename Layout = DefaultLayout>
+class BasicSerializedView;
+
+/**
+ * @brief The SerializedObject using the layout configured by the _BAS_* macros.
+ * @see BasicSerializedObject
+ */
+using SerializedObject = BasicSerializedObject<>;
+
+/**
+ * @brief The SerializedView using the layout configured by the _BAS_* macros.
+ * @see BasicSerializedView
+ */
+using SerializedView = BasicSerializedView<>;
+
+template <typename Layout = DefaultLayout>
+class BasicStreamFramer;
+
+/**
+ * @brief The StreamFramer using the layout configured by the _BAS_* macros.
+ * @see BasicStreamFramer
+ */
+using StreamFramer = BasicStreamFramer<>;
+
+template <typename Layout = DefaultLayout>
+class BasicBatchWriter;
+
+template <typename Layout = DefaultLayout>
+class BasicBatchReader;
+
+/**
+ * @brief The BatchWriter using the layout configured by the _BAS_* macros.
+ * @see BasicBatchWriter
+ */
+using BatchWriter = BasicBatchWriter<>;
+
+/**
+ * @brief The BatchReader using the layout configured by the _BAS_* macros.
+ * @see BasicBatchReader
+ */
+using BatchReader = BasicBatchReader<>;
+
+template <typename Layout = DefaultLayout>
+class BasicArchiveWriter;
+
+/**
+ * @brief The ArchiveWriter using the layout configured by the _BAS_* macros.
+ * @see BasicArchiveWriter
+ */
+using ArchiveWriter = BasicArchiveWriter<>;
+
+#ifdef _BAS_HAS_MMAP_
+template <typename Layout = DefaultLayout>
+class BasicArchiveReader;
+
+/**
+ * @brief The ArchiveReader using the layout configured by the _BAS_* macros.
+ * @see BasicArchiveReader
+ */
+using ArchiveReader = BasicArchiveReader<>;
+#endif
+
+template <typename Layout = DefaultLayout>
+class BasicCompressor;
+
+/**
+ * @brief Compressor is the BasicCompressor using DefaultLayout.
+ */
+using Compressor = BasicCompressor<>;
+
+template <typename Layout = DefaultLayout>
+class BasicSpscQueue;
+
+/**
+ * @brief SpscQueue is the BasicSpscQueue using DefaultLayout.
+ */
+using SpscQueue = BasicSpscQueue<>;
+
+template <typename Layout = DefaultLayout>
+class BasicMpscQueue;
+
+/**
+ * @brief MpscQueue is the BasicMpscQueue using DefaultLayout.
+ */
+using MpscQueue = BasicMpscQueue<>;
+
+template <typename Layout = DefaultLayout>
+class BasicObjectPool;
+
+/**
+ * @brief ObjectPool is the BasicObjectPool using DefaultLayout.
+ */
+using ObjectPool = BasicObjectPool<>;
+
+template <typename Layout = DefaultLayout>
+class BasicFieldIndex;
+
+/**
+ * @brief FieldIndex is the BasicFieldIndex using DefaultLayout.
+ */
+using FieldIndex = BasicFieldIndex<>;
+
+/**
+ * @brief Thrown when a payload is malformed: data popped past its end, or a length header out of bounds.
+ */
+class PayloadError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+/**
+ * @brief A contiguous part of a payload, as listed by BasicSerializedObject::gather().
+ */
+struct IoSegment {
+    const char* data;
+    size_t size;
+};
+
+/// \cond
+/**
+ * Reads the metadata of the next data, checking that it and the data fit in the available Bytes.
+ */
+template <typename Layout>
+inline size_t readBoundedSizes(const char* data, size_t available, size_t& size, size_t& array_size)
+{
+    size_t length = 0;
+
+    if (available >= Layout::MAX_SIZES_LENGTH) {
+        length = Layout::readSizes(data, size, array_size);
+    } else {
+        char sizes[Layout::MAX_SIZES_LENGTH] = {};
+
+        if (available)
+            std::memcpy(sizes, data, available);
+        length = Layout::readSizes(sizes, size, array_size);
+    }
+    if (length > available || (array_size != 0 && (size == 0 || size > (available - length) / array_size)))
+        throw PayloadError("bas: data popped past the end of the payload");
+    return length;
+}
+
+/**
+ * Calls function(chunk, begin, end) for each chunk of [0, count) on up to threads threads.
+ * The first exception thrown by function stops the remaining chunks and is rethrown.
+ */
+template <typename Function>
+inline void parallelChunks(size_t count, size_t chunkSize, size_t threads, Function function)
+{
+    size_t chunks = (count + chunkSize - 1) / chunkSize;
+    std::atomic<size_t> next { 0 };
+    std::exception_ptr error;
+    std::mutex mutex;
+    std::vector<std::thread> workers;
+
+    auto work = [&]() {
+        for (size_t chunk = next++; chunk < chunks; chunk = next++) {
+            try {
+                function(chunk, chunk * chunkSize, std::min(count, (chunk + 1) * chunkSize));
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+
+                if (!error)
+                    error = std::current_exception();
+                next = chunks;
+            }
+        }
+    };
+
+    threads = std::min(threads, chunks);
+    for (size_t i = 1; i < threads; i++)
+        workers.emplace_back(work);
+    work();
+    for (std::thread& worker : workers)
+        worker.join();
+    if (error)
+        std::rethrow_exception(error);
+}
+
+inline size_t defaultThreads(void)
+{
+    size_t threads = std::thread::hardware_concurrency();
+
+    return threads ? threads : 1;
+}
+/// \endcond
+
+/**
+ * @brief Tag type of bas::sizing.
+ */
+struct Sizing {
+};
+
+/**
+ * @brief Constructs a SerializedObject that only computes the size of what is pushed into it.
+ * @see BasicSerializedObject::BasicSerializedObject(Sizing)
+ */
+inline constexpr Sizing sizing {};
+
+/**
+ * @brief The Arena is a monotonic memory resource meant to back SerializedObjects.
+ * 
+ * Allocating from the Arena only moves a pointer forward and deallocating does nothing,
+ * the memory is reclaimed all at once by reset(). Since reset() keeps the blocks allocated
+ * from upstream, an Arena reset after each batch of serializations reaches a steady state
+ * where no allocation is made at all.\n
+ * The Arena is not thread safe, and must outlive every SerializedObject using it.
+ * @see BasicSerializedObject::BasicSerializedObject(std::pmr::memory_resource*)
+ */
+class Arena : public std::pmr::memory_resource {
+public:
+    /**
+     * @brief Construct an empty Arena.
+     * @param blockSize The minimum size of the blocks allocated from upstream.
+     * @param upstream The memory resource the blocks are allocated from.
+     */
+    inline Arena(size_t blockSize = 65536, std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+        : _blockSize(blockSize)
+        , _upstream(upstream)
+    {
+    }
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    /**
+     * @brief Destructor, gives every block back to upstream.
+     */
+    inline ~Arena()
+    {
+        release();
+    }
+
+    /**
+     * @brief Make all the memory of the Arena available again.
+     * 
+     * Everything allocated from the Arena is invalidated, the blocks are kept for later allocations.
+     */
+    inline void reset(void)
+    {
+        _current = 0;
+        _offset = 0;
+    }
+
+    /**
+     * @brief Give every block back to upstream.
+     * 
+     * Everything allocated from the Arena is invalidated.
+     */
+    inline void release(void)
+    {
+        for (Block& block : _blocks)
+            _upstream->deallocate(block.data, block.size);
+        _blocks.clear();
+        reset();
+    }
+
+    /**
+     * @brief Returns the total size of the blocks held by the Arena in Bytes.
+     */
+    inline size_t capacity(void) const
+    {
+        size_t capacity = 0;
+
+        for (const Block& block : _blocks)
+            capacity += block.size;
+        return capacity;
+    }
+
+private:
+    struct Block {
+        char* data;
+        size_t size;
+    };
+
+    inline void* do_allocate(size_t bytes, size_t alignment) override
+    {
+        for (; _current < _blocks.size(); _current++, _offset = 0) {
+            Block& block = _blocks[_current];
+            std::uintptr_t address = reinterpret_cast<std::uintptr_t>(block.data) + _offset;
+            size_t offset = _offset + ((alignment - address % alignment) % alignment);
+
+            if (offset + bytes <= block.size) {
+                _offset = offset + bytes;
+                return block.data + offset;
+            }
+        }
+        size_t size = bytes + alignment > _blockSize ? bytes + alignment : _blockSize;
+
+        _blocks.push_back({ (char*)_upstream->allocate(size, alignof(std::max_align_t)), size });
+        _offset = 0;
+        return do_allocate(bytes, alignment);
+    }
+
+    inline void do_deallocate(void*, size_t, size_t) override
+    {
+    }
+
+    inline bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+
+    std::vector<Block> _blocks;
+    size_t _current = 0; // Block currently allocated from
+    size_t _offset = 0;  // Position of the next allocation in the current block
+    size_t _blockSize;
+    std::pmr::memory_resource* _upstream;
+};
+
+/**
+ * @brief The Buffer is the storage of the payload of a SerializedObject.
+ * 
+ * The Buffer behaves like a std::vector<char>, except that payloads up to _BAS_INLINE_CAPACITY_
+ * Bytes are stored inline, without any allocation. Bigger payloads are allocated from a
+ * std::pmr::memory_resource.
+ * @see SerializedObject::buffer()
+ */
+class Buffer {
+public:
+    /**
+     * @brief Construct an empty Buffer.
+     * @param resource The memory resource used once the payload exceeds the inline capacity.
+     */
+    explicit inline Buffer(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : _resource(resource)
+    {
+    }
+
+    /**
+     * @brief Copy-construct Buffer, the copy uses the default memory resource.
+     */
+    inline Buffer(const Buffer& other)
+    {
+        assign(other.begin(), other.end());
+    }
+
+    /**
+     * @brief Move-construct Buffer, other is left empty.
+     */
+    inline Buffer(Buffer&& other) noexcept
+        : _resource(other._resource)
+    {
+        steal(other);
+    }
+
+    inline ~Buffer()
+    {
+        deallocate();
+    }
+
+    inline Buffer& operator=(const Buffer& other)
+    {
+        if (this != &other)
+            assign(other.begin(), other.end());
+        return *this;
+    }
+
+    /**
+     * @brief Move Buffer, the data of other is copied if both Buffers use different memory resources.
+     */
+    inline Buffer& operator=(Buffer&& other)
+    {
+        if (this == &other)
+            return *this;
+        if (other.isInline() || !_resource->is_equal(*other._resource)) {
+            assign(other.begin(), other.end());
+            other.clear();
+            return *this;
+        }
+        deallocate();
+        steal(other);
+        return *this;
+    }
+
+    inline char* data(void)
+    {
+        return _data;
+    }
+
+    inline const char* data(void) const
+    {
+        return _data;
+    }
+
+    inline char* begin(void)
+    {
+        return _data;
+    }
+
+    inline const char* begin(void) const
+    {
+        return _data;
+    }
+
+    inline char* end(void)
+    {
+        return _data + _size;
+    }
+
+    inline const char* end(void) const
+    {
+        return _data + _size;
+    }
+
+    inline char& operator[](size_t i)
+    {
+        return _data[i];
+    }
+
+    inline const char& operator[](size_t i) const
+    {
+        return _data[i];
+    }
+
+    inline size_t size(void) const
+    {
+        return _size;
+    }
+
+    inline bool empty(void) const
+    {
+        return _size == 0;
+    }
+
+    inline size_t capacity(void) const
+    {
+        return _capacity;
+    }
+
+    /**
+     * @brief Returns the memory resource used once the payload exceeds the inline capacity.
+     */
+    inline std::pmr::memory_resource* resource(void) const
+    {
+        return _resource;
+    }
+
+    inline void reserve(size_t capacity)
+    {
+        if (capacity <= _capacity)
+            return;
+        char* data = (char*)_resource->allocate(capacity, alignof(std::max_align_t));
+
+        std::memcpy(data, _data, _size);
+        deallocate();
+        _data = data;
+        _capacity = capacity;
+    }
+
+    inline void resize(size_t size)
+    {
+        grow(size);
+        if (size > _size)
+            std::memset(_data + _size, 0, size - _size);
+        _size = size;
+    }
+
+    /**
+     * @brief Grows the Buffer by count Bytes left uninitialized, and returns a pointer to them.
+     */
+    inline char* append(size_t count)
+    {
+        grow(_size + count);
+        _size += count;
+        return _data + _size - count;
+    }
+
+    inline void clear(void)
+    {
+        _size = 0;
+    }
+
+    inline void push_back(char c)
+    {
+        grow(_size + 1);
+        _data[_size++] = c;
+    }
+
+    inline void assign(const char* first, const char* last)
+    {
+        size_t size = last - first;
+
+        grow(size);
+        std::memmove(_data, first, size);
+        _size = size;
+    }
+
+    inline char* insert(char* pos, const char* first, const char* last)
+    {
+        size_t offset = pos - _data;
+        size_t count = last - first;
+
+        if (count == 0)
+            return pos;
+        grow(_size + count);
+        std::memmove(_data + offset + count, _data + offset, _size - offset);
+        std::memcpy(_data + offset, first, count);
+        _size += count;
+        return _data + offset;
+    }
+
+    inline char* insert(char* pos, size_t count, char value)
+    {
+        size_t offset = pos - _data;
+
+        grow(_size + count);
+        std::memmove(_data + offset + count, _data + offset, _size - offset);
+        std::memset(_data + offset, value, count);
+        _size += count;
+        return _data + offset;
+    }
+
+    inline char* erase(char* first, char* last)
+    {
+        std::memmove(first, last, end() - last);
+        _size -= last - first;
+        return first;
+    }
+
+private:
+    inline bool isInline(void) const
+    {
+        return _data == _inline;
+    }
+
+    inline void grow(size_t size)
+    {
+        if (size > _capacity)
+            reserve(size > _capacity * 2 ? size : _capacity * 2);
+    }
+
+    inline void deallocate(void)
+    {
+        if (!isInline())
+            _resource->deallocate(_data, _capacity, alignof(std::max_align_t));
+        _data = _inline;
+        _capacity = _BAS_INLINE_CAPACITY_;
+    }
+
+    inline void steal(Buffer& other)
+    {
+        if (other.isInline()) {
+            std::memcpy(_inline, other._inline, other._size);
+        } else {
+            _data = other._data;
+            _capacity = other._capacity;
+            other._data = other._inline;
+            other._capacity = _BAS_INLINE_CAPACITY_;
+        }
+        _size = other._size;
+        other._size = 0;
+    }
+
+    alignas(std::max_align_t) char _inline[_BAS_INLINE_CAPACITY_ > 0 ? _BAS_INLINE_CAPACITY_ : 1];
+    char* _data = _inline;
+    size_t _size = 0;
+    size_t _capacity = _BAS_INLINE_CAPACITY_;
+    std::pmr::memory_resource* _resource = std::pmr::get_default_resource();
+};
+
+/// \cond
+/**
+ * The codecs of pushDataEncoded() and BasicCompressor. Encoders append to a Buffer,
+ * decoders write exactly the expected number of elements and throw PayloadError on malformed input.
+ */
+struct Codecs {
+    static constexpr size_t LZ_MIN_MATCH = 4;
+    static constexpr size_t LZ_WINDOW = 65535;
+    static constexpr size_t LZ_HASH_BITS = 12;
+
+    static inline size_t readVarint(const char*& data, const char* end)
+    {
+        size_t number = 0;
+
+        for (size_t shift = 0; shift < sizeof(size_t) * 8; shift += 7) {
+            if (data == end)
+                break;
+            unsigned char byte = *data++;
+
+            number |= static_cast<size_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80))
+                return number;
+        }
+        throw PayloadError("bas: malformed encoded data");
+    }
+
+    template <typename T>
+    static constexpr bool isDeltaEncodable = std::is_integral_v<T> && !std::is_same_v<T, bool>;
+
+    // [codec][number of elements][encoded elements], the Bytes of an array pushed by pushDataEncoded()
+    template <typename Layout, typename T>
+    static inline void encodeArray(Buffer& out, const T* data, size_t count, Codec codec)
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "only arrays of trivially copyable types can be encoded");
+        char* header = out.append(1 + Wire::MAX_VARINT_LENGTH);
+
+        header[0] = static_cast<char>(codec);
+        out.resize(header + 1 + Wire::writeVarint(header + 1, count) - out.data());
+        if (codec == Codec::Delta) {
+            if constexpr (isDeltaEncodable<T>)
+                encodeDelta(out, data, count);
+            else
+                throw std::invalid_argument("bas: delta encoding only applies to integers");
+            return;
+        }
+        if (codec != Codec::None && codec != Codec::Rle && codec != Codec::Lz)
+            throw std::invalid_argument("bas: unknown codec");
+        const char* bytes = (const char*)data;
+        Buffer swapped(out.resource());
+
+        if constexpr (Layout::SWAP_BYTES && Wire::isSwappable<T>) {
+            Wire::swapBytes<sizeof(T)>(swapped.append(count * sizeof(T)), bytes, count);
+            bytes = swapped.data();
+        }
+        if (codec == Codec::None && count != 0)
+            std::memcpy(out.append(count * sizeof(T)), bytes, count * sizeof(T));
+        else if (codec == Codec::Rle)
+            encodeRle(out, bytes, count, sizeof(T));
+        else if (codec == Codec::Lz)
+            encodeLz(out, bytes, count * sizeof(T));
+    }
+
+    template <typename Layout, typename T>
+    static inline std::vector<T> decodeArray(const char* data, size_t size)
+    {
+        const char* end = data + size;
+
+        if (size == 0)
+            throw PayloadError("bas: malformed encoded data");
+        Codec codec = static_cast<Codec>(*data++);
+        size_t count = readVarint(data, end);
+
+        if (count > _BAS_MAX_FRAME_SIZE_ / sizeof(T))
+            throw PayloadError("bas: encoded array size out of bounds");
+        std::vector<T> array(count);
+        char* out = (char*)array.data();
+
+        switch (codec) {
+        case Codec::None:
+            if (static_cast<size_t>(end - data) != count * sizeof(T))
+                throw PayloadError("bas: malformed encoded data");
+            if (count != 0)
+                std::memcpy(out, data, count * sizeof(T));
+            break;
+        case Codec::Delta:
+            if constexpr (isDeltaEncodable<T>) {
+                decodeDelta(data, end, array.data(), count);
+                return array;
+            }
+            throw PayloadError("bas: delta encoded array popped as non integers");
+        case Codec::Rle:
+            decodeRle(data, end, out, count, sizeof(T));
+            break;
+        case Codec::Lz:
+            decodeLz(data, end, out, count * sizeof(T));
+            break;
+        default:
+            throw PayloadError("bas: unknown codec");
+        }
+        if constexpr (Layout::SWAP_BYTES && Wire::isSwappable<T>)
+            Wire::swapBytes<sizeof(T)>(out, out, count);
+        return array;
+    }
+
+    template <typename T>
+    static inline void encodeDelta(Buffer& out, const T* data, size_t count)
+    {
+        using Unsigned = std::make_unsigned_t<T>;
+        char* cursor = out.append(count * Wire::varintLength(std::numeric_limits<Unsigned>::max()));
+        Unsigned previous = 0;
+
+        for (size_t i = 0; i < count; i++) {
+            Unsigned delta = static_cast<Unsigned>(static_cast<Unsigned>(data[i]) - previous);
+            Unsigned sign = static_cast<Unsigned>(delta >> (sizeof(Unsigned) * 8 - 1));
+
+            cursor += Wire::writeVarint(cursor, static_cast<Unsigned>(static_cast<Unsigned>(delta << 1) ^ static_cast<Unsigned>(0 - sign)));
+            previous = static_cast<Unsigned>(data[i]);
+        }
+        out.resize(cursor - out.data());
+    }
+
+    template <typename T>
+    static inline void decodeDelta(const char* data, const char* end, T* out, size_t count)
+    {
+        using Unsigned = std::make_unsigned_t<T>;
+        Unsigned previous = 0;
+
+        for (size_t i = 0; i < count; i++) {
+            size_t zigzag = readVarint(data, end);
+
+            if (zigzag > std::numeric_limits<Unsigned>::max())
+                throw PayloadError("bas: malformed encoded data");
+            previous = static_cast<Unsigned>(previous + (static_cast<Unsigned>(zigzag >> 1) ^ static_cast<Unsigned>(0 - (zigzag & 1))));
+            out[i] = static_cast<T>(previous);
+        }
+        if (data != end)
+            throw PayloadError("bas: malformed encoded data");
+    }
+
+    // Runs of count elements of elementSize Bytes, as a varint length followed by the element
+    static inline void encodeRle(Buffer& out, const char* data, size_t count, size_t elementSize)
+    {
+        char* cursor = out.append(count * (elementSize + 1) + Wire::MAX_VARINT_LENGTH);
+
+        for (size_t i = 0; i < count;) {
+            const char* element = data + i * elementSize;
+            size_t run = 1;
+
+            if (elementSize == 1) {
+                while (i + run < count && element[run] == element[0])
+                    run++;
+            } else {
+                while (i + run < count && std::memcmp(element + run * elementSize, element, elementSize) == 0)
+                    run++;
+            }
+            cursor += Wire::writeVarint(cursor, run);
+            std::memcpy(cursor, element, elementSize);
+            cursor += elementSize;
+            i += run;
+        }
+        out.resize(cursor - out.data());
+    }
+
+    static inline void decodeRle(const char* data, const char* end, char* out, size_t count, size_t elementSize)
+    {
+        for (size_t i = 0; i < count;) {
+            size_t run = readVarint(data, end);
+
+            if (run == 0 || run > count - i || static_cast<size_t>(end - data) < elementSize)
+                throw PayloadError("bas: malformed encoded data");
+            for (size_t j = 0; j < run; j++, i++)
+                std::memcpy(out + i * elementSize, data, elementSize);
+            data += elementSize;
+        }
+        if (data != end)
+            throw PayloadError("bas: malformed encoded data");
+    }
+
+    /**
+     * Sequences of [token][literal length][literals][offset][match length]: the token holds
+     * the literal length and the match length minus LZ_MIN_MATCH on 4 bits each, extended by
+     * Bytes of 255 when they are 15. The offset is stored on 2 Bytes. The last sequence has no match.
+     */
+    static inline void encodeLz(Buffer& out, const char* data, size_t size)
+    {
+        char* cursor = out.append(size + size / 255 + 16);
+        size_t table[size_t(1) << LZ_HASH_BITS] = {}; // Position + 1 of the last sequence of each hash
+        size_t anchor = 0;
+        size_t i = 0;
+
+        while (i + LZ_MIN_MATCH <= size) {
+            uint32_t sequence = load32(data + i);
+            size_t& entry = table[(sequence * 2654435761u) >> (32 - LZ_HASH_BITS)];
+            size_t candidate = entry;
+
+            entry = i + 1;
+            if (candidate == 0 || i + 1 - candidate > LZ_WINDOW || load32(data + candidate - 1) != sequence) {
+                i += 1 + ((i - anchor) >> 6); // Skip faster through incompressible data
+                continue;
+            }
+            size_t length = LZ_MIN_MATCH;
+
+            while (i + length < size && data[candidate - 1 + length] == data[i + length])
+                length++;
+            cursor = writeLzSequence(cursor, data + anchor, i - anchor, i + 1 - candidate, length);
+            i += length;
+            anchor = i;
+        }
+        cursor = writeLzSequence(cursor, data + anchor, size - anchor, 0, 0);
+        out.resize(cursor - out.data());
+    }
+
+    static inline void decodeLz(const char* data, const char* end, char* out, size_t size)
+    {
+        size_t position = 0;
+
+        while (true) {
+            if (data == end)
+                throw PayloadError("bas: malformed encoded data");
+            unsigned char token = *data++;
+            size_t literals = readLzLength(data, end, token >> 4);
+
+            if (literals > static_cast<size_t>(end - data) || literals > size - position)
+                throw PayloadError("bas: malformed encoded data");
+            if (literals != 0)
+                std::memcpy(out + position, data, literals);
+            data += literals;
+            position += literals;
+            if (data == end)
+                break;
+            if (end - data < 2)
+                throw PayloadError("bas: malformed encoded data");
+            size_t offset = Wire::load<2>(data);
+
+            data += 2;
+            size_t length = readLzLength(data, end, token & 0x0F) + LZ_MIN_MATCH;
+
+            if (offset == 0 || offset > position || length > size - position)
+                throw PayloadError("bas: malformed encoded data");
+            for (size_t copied = 0; copied < length; copied += offset) // Overlapping matches repeat the last offset Bytes
+                std::memcpy(out + position + copied, out + position + copied - offset, std::min(offset, length - copied));
+            position += length;
+        }
+        if (position != size)
+            throw PayloadError("bas: malformed encoded data");
+    }
+
+private:
+    static inline uint32_t load32(const char* data)
+    {
+        uint32_t number;
+
+        std::memcpy(&number, data, sizeof(number));
+        return number;
+    }
+
+    static inline char* writeLzLength(char* cursor, size_t length)
+    {
+        for (; length >= 255; length -= 255)
+            *cursor++ = static_cast<char>(255);
+        *cursor++ = static_cast<char>(length);
+        return cursor;
+    }
+
+    static inline size_t readLzLength(const char*& data, const char* end, size_t length)
+    {
+        unsigned char byte = 255;
+
+        if (length != 15)
+            return length;
+        while (byte == 255) {
+            if (data == end)
+                throw PayloadError("bas: malformed encoded data");
+            byte = *data++;
+            length += byte;
+        }
+        return length;
+    }
+
+    static inline char* writeLzSequence(char* cursor, const char* literals, size_t literalLength, size_t offset, size_t matchLength)
+    {
+        size_t match = matchLength != 0 ? matchLength - LZ_MIN_MATCH : 0;
+
+        *cursor++ = static_cast<char>((std::min<size_t>(literalLength, 15) << 4) | std::min<size_t>(match, 15));
+        if (literalLength >= 15)
+            cursor = writeLzLength(cursor, literalLength - 15);
+        if (literalLength != 0)
+            std::memcpy(cursor, literals, literalLength);
+        cursor += literalLength;
+        if (matchLength == 0)
+            return cursor;
+        Wire::store<2>(cursor, offset);
+        cursor += 2;
+        if (match >= 15)
+            cursor = writeLzLength(cursor, match - 15);
+        return cursor;
+    }
+};
+/// \endcond
+
+/**
+ * @brief The SerializedObject contains and manages the payload of your serializations.
+ * 
+ * This class is the result of a Serializable::serialization.\n
+ * The metadata of the payload is stored as described by Layout, SerializedObject is the
+ * BasicSerializedObject using DefaultLayout.
+ * @tparam Layout The layout of the payload, FixedLayout or VarintLayout.
+ */
+template <typename Layout>
+class BasicSerializedObject {
+public:
+    using LayoutType = Layout;
+
+    BasicSerializedObject()
+    {
+        prepareChecksum();
+    }
+
+    /**
+     * @brief Construct object whose payload is allocated from resource.
+     * 
+     * resource must outlive the SerializedObject.
+     * @param resource The memory resource the payload is allocated from, an Arena for example.
+     * @see Arena
+     */
+    explicit inline BasicSerializedObject(std::pmr::memory_resource* resource)
+        : _data(resource)
+        , _refs(resource)
+    {
+        prepareChecksum();
+    }
+
+    /**
+     * @brief Construct object that only computes the size of its payload.
+     * 
+     * Pushing data into this object does not copy anything, it only adds the size the data
+     * would take in the payload to size(). The payload itself stays empty.
+     * @see Serializable::serializedSize()
+     */
+    explicit inline BasicSerializedObject(Sizing)
+        : _isSizing(true)
+    {
+        prepareChecksum();
+    }
+
+    /**
+     * @brief Construct object from payload.
+     * 
+     * This operation makes a copy of data.
+     * @param data payload the SerializedObject will be assigned.
+     * @throw PayloadError If the checksum is smaller than itself, or if the CRC of a Crc32cLayout does not match.
+     */
+    inline BasicSerializedObject(const char* data)
+    {
+        constructFromPayload(data);
+    }
+
+    /**
+     * @brief Construct object from payload, allocated from resource.
+     * 
+     * This operation makes a copy of data.
+     * @param data payload the SerializedObject will be assigned.
+     * @param resource The memory resource the payload is allocated from.
+     * @throw PayloadError If the checksum is smaller than itself, or if the CRC of a Crc32cLayout does not match.
+     */
+    inline BasicSerializedObject(const char* data, std::pmr::memory_resource* resource)
+        : _data(resource)
+        , _refs(resource)
+    {
+        constructFromPayload(data);
+    }
+
+    /**
+     * @brief Construct object from a payload received in a buffer of size Bytes.
+     * 
+     * This operation makes a copy of data.
+     * Unlike BasicSerializedObject(const char*), the checksum is checked against size.
+     * @param data payload the SerializedObject will be assigned.
+     * @param size The number of Bytes available at data.
+     * @param resource The memory resource the payload is allocated from.
+     * @throw PayloadError If the checksum does not fit in size, or if the CRC of a Crc32cLayout does not match.
+     */
+    inline BasicSerializedObject(const char* data, size_t size, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : _data(resource)
+        , _refs(resource)
+    {
+        if (size < Layout::CHECKSUM_SIZE || Layout::readChecksum(data) < Layout::CHECKSUM_SIZE || Layout::readChecksum(data) > size)
+            throw PayloadError("bas: payload size does not match its checksum");
+        constructFromPayload(data);
+    }
+
+
+    /**
+     * @brief Copy-construct object from another SerializedObject.
+     * 
+     * The copy is allocated from the default memory resource, not from the resource of other.
+     * @param other The SerializedObject to be copied from.
+     */
+    inline BasicSerializedObject(const BasicSerializedObject& other)
+        : _data(other._data)
+        , _refs(other._refs)
+        , _refBytes(other._refBytes)
+        , _readOffset(other._readOffset)
+        , _readEnd(other._readEnd)
+        , _isChecksumRemoved(other._isChecksumRemoved)
+        , _isChecksumOutdated(other._isChecksumOutdated)
+        , _isSizing(other._isSizing)
+        , _sizedBytes(other._sizedBytes)
+    {
+    }
+
+    /**
+     * @brief Move-construct object from another SerializedObject.
+     * 
+     * The payload of other is not copied, other is left empty as after a call to clear().
+     * @param other The SerializedObject to be moved from.
+     */
+    inline BasicSerializedObject(BasicSerializedObject&& other) noexcept
+        : _data(std::move(other._data))
+        , _refs(std::move(other._refs))
+        , _refBytes(other._refBytes)
+        , _readOffset(other._readOffset)
+        , _readEnd(other._readEnd)
+        , _isChecksumRemoved(other._isChecksumRemoved)
+        , _isChecksumOutdated(other._isChecksumOutdated)
+        , _isSizing(other._isSizing)
+        , _sizedBytes(other._sizedBytes)
+    {
+        other.clear();
+    }
+
+    /**
+     * @brief Default destructor.
+     */
+    ~BasicSerializedObject() = default;
+
+    /**
+     * @brief Pushes data into the payload.
+     * 
+     * To retreive data pushed by this variant of pushData(), 
+     * use popData<T>() where T is the type of the data pushed.
+     * @param data Data to be pushed.
+     * @see popData<>()
+     */
+    template <typename T>
+    inline void pushData(const T& data)
+    {
+        Helper<T> helper;
+        helper.pushData(*this, data);
+    }
+
+    /**
+     * @brief Pushes an array of data into the object payload.
+     * 
+     * To retreive data pushed by this variant of pushData(),
+     * use popDataArray<T>() where T is the type of the data pushed.
+     * @param data A pointer to the data to be pushed.
+     * @param array_size The size of the array to be pushed.
+     * @see popDataArray<>()
+     */
+    template <typename T>
+    inline void pushData(const T* data, size_t array_size)
+    {
+        size_t size = sizeof(T);
+
+        pushSizes(size, array_size);
+
+        pushRawArray(data, array_size);
+
+        checksumUpdate();
+    }
+
+    /**
+     * @brief Pushes an array encoded with codec into the payload.
+     * 
+     * The array is stored as an array of Bytes holding the codec, the number of elements
+     * and the encoded elements, which must fit in the array size of the layout.
+     * It must be popped with popDataEncoded().\n
+     * Codec::Delta stores the differences between consecutive integers as varints, which is
+     * compact for slowly varying integers. Codec::Rle stores runs of equal elements, Codec::Lz repeated sequences of Bytes.
+     * @param data A pointer to the data to be pushed.
+     * @param array_size The size of the array to be pushed.
+     * @param codec The encoding of the array.
+     * @throw std::invalid_argument If codec is Codec::Delta and T is not an integer type.
+     */
+    template <typename T>
+    inline void pushDataEncoded(const T* data, size_t array_size, Codec codec)
+    {
+        Buffer encoded(_data.resource());
+
+        Codecs::encodeArray<Layout>(encoded, data, array_size, codec);
+        pushData(encoded.data(), encoded.size());
+    }
+
+    /**
+     * @brief Pushes a vector encoded with codec into the payload.
+     * @see pushDataEncoded(const T*, size_t, Codec)
+     */
+    template <typename T>
+    inline void pushDataEncoded(const std::vector<T>& data, Codec codec)
+    {
+        pushDataEncoded(data.data(), data.size(), codec);
+    }
+
+    /**
+     * @brief Pushes an array into the payload by reference, without copying it.
+     * 
+     * Only the metadata of the array is written in the payload, the array itself is
+     * listed by gather() as a segment pointing to data, so it can be sent with writev() or sendmsg()
+     * without being copied. The payload is the same as with pushData(data, array_size).\n
+     * data must stay valid and unchanged until the payload is sent, or until payload() is called:
+     * payload() and popping copy the referenced arrays into the payload.\n
+     * Arrays of swapped numbers and arrays pushed with a Crc32cLayout are copied, as with pushData().
+     * @param data A pointer to the data to be pushed.
+     * @param array_size The size of the array to be pushed.
+     * @see gather()
+     */
+    template <typename T>
+    inline void pushDataRef(const T* data, size_t array_size)
+    {
+        size_t size = sizeof(T);
+
+        if constexpr (Layout::SWAP_BYTES && Wire::isSwappable<T>) {
+            pushData(data, array_size); // The numbers are swapped while being copied
+            return;
+        }
+        if constexpr (Layout::HAS_CRC) {
+            pushData(data, array_size); // The CRC is computed over a contiguous payload
+            return;
+        }
+        if (_isSizing) {
+            _sizedBytes += Layout::sizesLength(size, array_size) + size * array_size;
+            return;
+        }
+        Layout::writeSizes(extend(Layout::sizesLength(size, array_size)), size, array_size);
+        if (array_size == 0)
+            return;
+        _refs.push_back({ _data.size(), (const char*)data, size * array_size });
+        _refBytes += size * array_size;
+    }
+
+    /**
+     * @brief Pushes a vector into the payload by reference, without copying it.
+     * 
+     * To retreive it, use popData<std::vector<T>>().
+     * @param data The vector to be pushed, which must not be modified until the payload is sent.
+     * @see pushDataRef(const T*, size_t)
+     */
+    template <typename T>
+    inline void pushDataRef(const std::vector<T>& data)
+    {
+        pushDataRef(data.data(), data.size());
+    }
+
+    /**
+     * @brief Serializes a Serializable or Reflectable object directly into the payload.
+     * 
+     * Like pushData(child.serialize()), without building the payload of the child separately:
+     * its metadata is reserved, the child pushes its data right after it,
+     * then the metadata is written with the final size of the child.\n
+     * The Bytes are the same as with pushData(child.serialize()) with a FixedLayout. With a VarintLayout,
+     * the size of the child is padded to Layout::NESTED_SIZES_LENGTH Bytes since it is written after the child.\n
+     * To retreive the child, use popObject() or popData<SerializedObject>().
+     * @param child The object to be serialized into the payload.
+     * @see popObject()
+     */
+    template <typename Child>
+    inline void pushObject(Child& child)
+    {
+        if (_isSizing) {
+            _sizedBytes += Layout::NESTED_SIZES_LENGTH + Layout::CHECKSUM_SIZE;
+            child.makeSerialization(*this);
+            return;
+        }
+        // extend() adds back a removed checksum, the positions are taken after it
+        extend(Layout::NESTED_SIZES_LENGTH + Layout::CHECKSUM_SIZE);
+
+        size_t start = _data.size() - Layout::NESTED_SIZES_LENGTH - Layout::CHECKSUM_SIZE;
+        size_t written = this->size() - Layout::NESTED_SIZES_LENGTH - Layout::CHECKSUM_SIZE;
+
+        child.makeSerialization(*this);
+
+        size_t size = this->size() - written - Layout::NESTED_SIZES_LENGTH;
+
+        Layout::writeNestedSizes(_data.data() + start, size);
+        Layout::writeChecksum(_data.data() + start + Layout::NESTED_SIZES_LENGTH, size);
+    }
+
+    /**
+     * @brief Unserializes a Serializable or Reflectable object nested in the payload.
+     * 
+     * The child pops its data directly from this payload, nothing is copied.
+     * While it does, popping past the end of the nested payload throws PayloadError.
+     * If the child throws, popping from this object is no longer bounded by the nested payload.
+     * @param child The object to be unserialized.
+     * @throw PayloadError If the child does not pop exactly the nested payload.
+     * @see pushObject()
+     */
+    template <typename Child>
+    inline void popObject(Child& child)
+    {
+        BasicSerializedView<Layout> nested = popData<BasicSerializedView<Layout>>();
+        size_t end = _readOffset;
+        size_t readEnd = _readEnd;
+
+        if (nested.size() < Layout::CHECKSUM_SIZE || Layout::readChecksum(nested.payload()) != nested.size())
+            throw PayloadError("bas: nested object does not match its size");
+        _readOffset = end - nested.size() + Layout::CHECKSUM_SIZE;
+        _readEnd = end;
+        try {
+            child.makeUnserialization(*this);
+        } catch (...) {
+            _readEnd = readEnd;
+            throw;
+        }
+        _readEnd = readEnd;
+        if (_readOffset != end)
+            throw PayloadError("bas: nested object does not match its size");
+    }
+
+    /**
+     * @brief Pop the next data in the payload.
+     *
+     * Popping does not modify the payload, it only moves the read cursor forward.
+     * @see rewind()
+     * @return The popped value from the payload.
+     * @throw PayloadError If the data does not fit in the payload or was not pushed as a T: a value of another size,
+     * an array of elements bigger than a char popped as a string, or a nested object that does not match its size.
+     */
+    template <typename T>
+    inline T popData(void)
+    {
+        Helper<T> helper;
+        return helper.popData(*this);
+    }
+
+    /**
+     * @brief Pop the next array in the payload and returns a PoppedArray.
+     * 
+     * The PoppedArray contains the popped data along with the size of the popped data.
+     * @see PoppedArray
+     */
+    template <typename T>
+    inline PoppedArray<T> popDataArray(void)
+    {
+        size_t size = 0;
+        size_t array_size = 0;
+        T* var;
+
+        std::tie(size, array_size) = getSizes();
+
+        var = new T[array_size];
+
+        copyMem(size, array_size, var);
+
+        return PoppedArray<T>(array_size, var);
+    }
+
+    /**
+     * @brief Pop the next array in the payload without copying it when possible.
+     * 
+     * If the popped array is suitably aligned in the payload, the returned PoppedSpan
+     * points directly into the payload, otherwise it holds a single copy of the array.
+     * @see PoppedSpan
+     */
+    template <typename T>
+    inline PoppedSpan<T> popDataSpan(void)
+    {
+        Helper<PoppedSpan<T>> helper;
+        return helper.popData(*this);
+    }
+
+    /**
+     * @brief Pop the next array pushed with pushDataEncoded(), whatever its codec.
+     * @throw PayloadError If the encoded array is malformed.
+     */
+    template <typename T>
+    inline std::vector<T> popDataEncoded(void)
+    {
+        size_t size = 0;
+        size_t array_size = 0;
+
+        std::tie(size, array_size) = getSizes();
+        return Codecs::decodeArray<Layout, T>(readData(size * array_size), size * array_size);
+    }
+
+    /**
+     * @brief Move the read cursor back to the first data of the payload.
+     *
+     * Allows the same SerializedObject to be popped from multiple times
+     * without making a copy of it.
+     */
+    inline void rewind(void)
+    {
+        _readOffset = _isChecksumRemoved ? 0 : Layout::CHECKSUM_SIZE;
+        _readEnd = NO_READ_END;
+    }
+
+    /**
+     * @brief Returns a pointer to the payload of the object.
+     * 
+     * This function is the go-to to get the 'finished product' of your serialization.\n
+     * The checksum is written here, once, instead of after every pushData().\n
+     * Although const, it writes the checksum and copies the arrays pushed by reference when the object was modified
+     * since it was last finalized: call finalize() first to call it from several threads at once.
+     * @return Pointer to the payload of the SerializedObject 
+     * @see finalize()
+     */
+    inline const char* payload(void) const
+    {
+        flatten();
+        writeChecksum();
+        return _data.data();
+    }
+
+    /**
+     * @brief Writes the checksum and copies the arrays pushed by reference into the payload.
+     * 
+     * payload() does it when needed, finalize() does it explicitly: until the object is modified again,
+     * its const functions then only read it and can be called from several threads at once,
+     * to build views of it for example.
+     */
+    inline void finalize(void)
+    {
+        flatten();
+        writeChecksum();
+    }
+
+    /**
+     * @brief Lists the segments of the payload, without copying the arrays pushed by reference.
+     * 
+     * The segments, in order, make up the payload: the parts stored in the object
+     * and the arrays pushed by pushDataRef(). Writes segmentCount() IoSegments to out.\n
+     * Although const, the first call after a modification writes the checksum, so it must not run concurrently
+     * with another const call on the object. Afterwards it only reads, until the next modification.
+     * finalize() writes the checksum too, but also copies the arrays pushed by reference into a single segment.
+     * @param out The output iterator the segments are written to.
+     * @return out past the last written segment.
+     * @see pushDataRef()
+     */
+    template <typename OutputIt>
+    inline OutputIt gather(OutputIt out) const
+    {
+        forEachSegment([&](const char* data, size_t size) { *out++ = IoSegment { data, size }; });
+        return out;
+    }
+
+#ifdef _BAS_HAS_IOVEC_
+    /**
+     * @brief Lists the segments of the payload as iovecs, ready for writev() or sendmsg().
+     * @param iov The array the segments are written to, of at least segmentCount() iovecs.
+     * @return The number of written iovecs.
+     * @note Writes the checksum like gather(OutputIt).
+     * @see gather(OutputIt)
+     */
+    inline size_t gather(struct iovec* iov) const
+    {
+        size_t count = 0;
+
+        forEachSegment([&](const char* data, size_t size) {
+            iov[count].iov_base = const_cast<char*>(data);
+            iov[count++].iov_len = size;
+        });
+        return count;
+    }
+#endif
+
+    /**
+     * @brief Returns the number of segments listed by gather().
+     * @note Writes the checksum like gather(OutputIt), so calling it once lets several threads gather() the object.
+     */
+    inline size_t segmentCount(void) const
+    {
+        size_t count = 0;
+
+        forEachSegment([&](const char*, size_t) { count++; });
+        return count;
+    }
+
+    /**
+     * @brief Returns a reference to the Buffer containing the payload.
+     * 
+     * User-end should use this function only in rare case, manually modifying 
+     * the payload may end up in undefined behaviours.
+     * @see Buffer
+     */
+    inline Buffer& buffer(void)
+    {
+        flatten();
+        writeChecksum();
+        return _data;
+    }
+
+    /**
+     * @brief Returns a reference to the Buffer containing the payload.
+     * 
+     * This used to return a std::vector<char>&: the payload is no longer stored in a std::vector<char>,
+     * so code binding the result to a std::vector<char>& no longer compiles and must use buffer() instead.
+     * @deprecated Use buffer().
+     */
+    [[deprecated("bas: vector() returns a Buffer& instead of a std::vector<char>&, use buffer()")]]
+    inline Buffer& vector(void)
+    {
+        return buffer();
+    }
+
+    /**
+     * @brief Returns the size of the payload in Bytes.
+     * 
+     * This size include all the metadata that is added by the SerializedObject to the payload.
+     * @return The size of the payload.
+     */
+    inline size_t size(void) const
+    {
+        return _data.size() + _refBytes + _sizedBytes;
+    }
+
+    /**
+     * @brief Returns true if the object only computes the size of its payload.
+     * @see BasicSerializedObject(Sizing)
+     */
+    inline bool isSizing(void) const
+    {
+        return _isSizing;
+    }
+
+    /**
+     * @brief Returns the memory resource the payload is allocated from.
+     */
+    inline std::pmr::memory_resource* resource(void) const
+    {
+        return _data.resource();
+    }
+
+    /**
+     * @brief Returns the number of Bytes the payload can hold without reallocating.
+     * @see reserve()
+     */
+    inline size_t capacity(void) const
+    {
+        return _data.capacity();
+    }
+
+    /**
+     * @brief Preallocate the payload so it can hold size Bytes without reallocating.
+     * 
+     * size is the total size of the payload, including the checksum and the 
+     * metadata added for every pushed data (_BAS_SIZE_BYTES_ + _BAS_ARRAY_SIZE_ Bytes, unless _BAS_VARINT_SIZES_ is set).\n
+     * Calling this function before pushing large arrays avoids repeated reallocations.
+     * @param size Number of Bytes to preallocate.
+     */
+    inline void reserve(size_t size)
+    {
+        _data.reserve(size);
+    }
+
+    /**
+     * @brief Clear the SerializedObject and resets it to its default values.
+     * 
+     * The object holds an empty payload, ready for a new serialization, and keeps the capacity of its payload.
+     * @see BasicObjectPool
+     */
+    inline void clear()
+    {
+        _refs.clear();
+        _refBytes = 0;
+        _isChecksumRemoved = false;
+        _sizedBytes = 0;
+        prepareChecksum();
+        rewind();
+    }
+
+    /**
+     * @brief Assign values to the SerializedObject.
+     * @param other SerializedObject to be copied from
+     */
+    inline BasicSerializedObject& operator=(const BasicSerializedObject& other)
+    {
+        _data = other._data;
+        _refs = other._refs;
+        _refBytes = other._refBytes;
+        _readOffset = other._readOffset;
+        _readEnd = other._readEnd;
+        _isChecksumRemoved = other._isChecksumRemoved;
+        _isChecksumOutdated = other._isChecksumOutdated;
+        _isSizing = other._isSizing;
+        _sizedBytes = other._sizedBytes;
+        return *this;
+    }
+
+    /**
+     * @brief Move values to the SerializedObject.
+     * 
+     * The payload of other is not copied unless both objects use different memory resources,
+     * other is left empty as after a call to clear().
+     * @param other SerializedObject to be moved from
+     */
+    inline BasicSerializedObject& operator=(BasicSerializedObject&& other)
+    {
+        if (this == &other)
+            return *this;
+        _data = std::move(other._data);
+        _refs = std::move(other._refs);
+        _refBytes = other._refBytes;
+        _readOffset = other._readOffset;
+        _readEnd = other._readEnd;
+        _isChecksumRemoved = other._isChecksumRemoved;
+        _isChecksumOutdated = other._isChecksumOutdated;
+        _isSizing = other._isSizing;
+        _sizedBytes = other._sizedBytes;
+        other.clear();
+        return *this;
+    }
+
+    /**
+     * @brief Assign a copy of data to the payload.
+     * 
+     * This function erase the current payload.\n
+     * If data is not a payload extracted with SerializedObject::payload(),
+     * behaviour might be undefined.
+     * @param data payload the SerializedObject will be assigned.
+     */
+    inline BasicSerializedObject& operator=(const char* data)
+    {
+        constructFromPayload(data);
+        return *this;
+    }
+
+    /**
+     * @brief Remove Checksum at the beggining of payload.
+     * 
+     * If checksum has already been removed, nothing is done.\n
+     * This function should not be used by user end, except for extremely rare case.
+     */
+    inline void removeChecksum(void)
+    {
+        if (_isChecksumRemoved)
+            return;
+        flatten();
+        _isChecksumRemoved = true;
+        _data.erase(_data.begin(), _data.begin() + Layout::CHECKSUM_SIZE);
+        _readOffset = _readOffset > Layout::CHECKSUM_SIZE ? _readOffset - Layout::CHECKSUM_SIZE : 0;
+    }
+
+    /**
+     * @brief Add Checksum at the beggining of payload.
+     * 
+     * If checksum has already been added, nothing is done.\n
+     * This function should not be used by user end, except for extremely rare case.
+     */
+    inline void addChecksum(void)
+    {
+        if (!_isChecksumRemoved)
+            return;
+        _isChecksumRemoved = false;
+        _data.insert(_data.begin(), Layout::CHECKSUM_SIZE, 0);
+        _readOffset += Layout::CHECKSUM_SIZE;
+        checksumUpdate();
+    }
+
+private:
+    inline void prepareChecksum(void)
+    {
+        _data.resize(Layout::CHECKSUM_SIZE);
+        _isChecksumOutdated = true;
+    }
+
+    inline void constructFromPayload(const char* data)
+    {
+        size_t size = Layout::readChecksum(data);
+
+        if (size < Layout::CHECKSUM_SIZE)
+            throw PayloadError("bas: payload size does not match its checksum");
+        if (!Layout::verifyChecksum(data, size))
+            throw PayloadError("bas: payload CRC mismatch");
+        _data.assign(data, data + size);
+        _refs.clear();
+        _refBytes = 0;
+        _isChecksumRemoved = false;
+        _isChecksumOutdated = false;
+        rewind();
+    }
+
+    inline void checksumUpdate(void)
+    {
+        if (_isChecksumRemoved)
+            addChecksum();
+        _isChecksumOutdated = true;
+    }
+
+    inline void writeChecksum(void) const
+    {
+        size_t size = _data.size() + _refBytes;
+
+        if (!_isChecksumOutdated || _isChecksumRemoved)
+            return;
+        Layout::writeChecksum(_data.data(), size);
+        _isChecksumOutdated = false;
+    }
+
+    // Copies the arrays pushed by reference into the payload, from the last one so that each Byte is moved once
+    inline void flatten(void) const
+    {
+        if (_refs.empty())
+            return;
+
+        size_t end = _data.size();
+        size_t shift = _refBytes;
+
+        _data.resize(end + _refBytes);
+        for (auto ref = _refs.rbegin(); ref != _refs.rend(); ++ref) {
+            std::memmove(_data.data() + ref->offset + shift, _data.data() + ref->offset, end - ref->offset);
+            shift -= ref->size;
+            std::memcpy(_data.data() + ref->offset + shift, ref->data, ref->size);
+            end = ref->offset;
+        }
+        _refs.clear();
+        _refBytes = 0;
+    }
+
+    template <typename Function>
+    inline void forEachSegment(Function function) const
+    {
+        size_t offset = 0;
+
+        writeChecksum();
+        for (const Reference& ref : _refs) {
+            if (ref.offset > offset)
+                function(_data.data() + offset, ref.offset - offset);
+            function(ref.data, ref.size);
+            offset = ref.offset;
+        }
+        if (_data.size() > offset)
+            function(_data.data() + offset, _data.size() - offset);
+    }
+
+    inline char* extend(size_t size)
+    {
+        checksumUpdate();
+
+        size_t offset = _data.size();
+
+        if (_data.capacity() < offset + size)
+            grow(size);
+        _data.resize(offset + size);
+        return _data.data() + offset;
+    }
+
+    inline void pushRawData(size_t size, size_t array_size, const char* data)
+    {
+        if (_isSizing) {
+            _sizedBytes += size * array_size;
+            return;
+        }
+        _data.insert(_data.end(), data, data + size * array_size);
+    }
+
+    template <typename T>
+    inline void pushRawArray(const T* data, size_t array_size)
+    {
+        if constexpr (Layout::SWAP_BYTES && Wire::isSwappable<T>) {
+            if (_isSizing) {
+                _sizedBytes += sizeof(T) * array_size;
+                return;
+            }
+            Wire::swapBytes<sizeof(T)>(_data.append(sizeof(T) * array_size), (const char*)data, array_size);
+        } else {
+            pushRawData(sizeof(T), array_size, (const char*)data);
+        }
+    }
+
+    inline void pushSizes(size_t size, size_t array_size)
+    {
+        char sizes[Layout::MAX_SIZES_LENGTH];
+        size_t length;
+
+        if (_isSizing) {
+            _sizedBytes += Layout::sizesLength(size, array_size);
+            return;
+        }
+        length = Layout::writeSizes(sizes, size, array_size);
+
+        // Growing once for the sizes and the data avoids a second reallocation in pushRawData
+        if (_data.capacity() < _data.size() + length + size * array_size)
+            grow(length + size * array_size);
+
+        _data.insert(_data.end(), sizes, sizes + length);
+    }
+
+    inline void grow(size_t additional)
+    {
+        size_t required = _data.size() + additional;
+
+        _data.reserve(required > _data.capacity() * 2 ? required : _data.capacity() * 2);
+    }
+
+    inline const char* readPointer(void) const
+    {
+        return _data.data() + _readOffset;
+    }
+
+    inline size_t remaining(void) const
+    {
+        size_t end = _data.size() < _readEnd ? _data.size() : _readEnd;
+
+        return end > _readOffset ? end - _readOffset : 0;
+    }
+
+    inline const char* readData(size_t size)
+    {
+        const char* data = _data.data() + _readOffset;
+
+        if (size > remaining())
+            throw PayloadError("bas: data popped past the end of the payload");
+        _readOffset += size;
+        return data;
+    }
+
+    inline std::tuple<size_t, size_t> getSizes(void)
+    {
+        size_t size = 0, array_size = 0;
+
+        flatten();
+        readData(readBoundedSizes<Layout>(readPointer(), remaining(), size, array_size));
+        return std::make_tuple(size, array_size);
+    }
+
+    template <typename T>
+    inline void copyMem(size_t size, size_t array_size, T* var)
+    {
+        const char* data = readData(size * array_size);
+
+        if (array_size == 0)
+            return;
+        if constexpr (Layout::SWAP_BYTES && Wire::isSwappable<T>) {
+            if (size == sizeof(T)) {
+                Wire::swapBytes<sizeof(T)>((char*)var, data, array_size);
+                return;
+            }
+        }
+        if (size == sizeof(T)) {
+            std::memcpy(var, data, size * array_size);
+        } else {
+            for (size_t j = 0; j < array_size; j++)
+                std::memcpy(var + j, data + j * size, size < sizeof(T) ? size : sizeof(T));
+        }
+    }
+
+    struct Reference {
+        size_t offset; // Position in _data the array is inserted at
+        const char* data;
+        size_t size;
+    };
+
+    mutable Buffer _data; // mutable so that the checksum can be written lazily by payload()
+    mutable std::pmr::vector<Reference> _refs; // Arrays pushed by reference, flattened into _data on demand
+    mutable size_t _refBytes = 0;
+    static constexpr size_t NO_READ_END = std::numeric_limits<size_t>::max();
+
+    size_t _readOffset = Layout::CHECKSUM_SIZE; // Position of the next data to be popped
+    size_t _readEnd = NO_READ_END; // End of the nested object being popped by popObject()
+    bool _isChecksumRemoved = false;
+    mutable bool _isChecksumOutdated = false;
+    bool _isSizing = false;
+    size_t _sizedBytes = 0; // Size of the data pushed while sizing
+
+    template <typename T>
+    friend class Helper;
+    template <typename Derived>
+    friend class Reflectable;
+    template <typename OtherLayout>
+    friend class BasicSerializedObject;
+    template <typename OtherLayout>
+    friend class BasicBatchWriter;
+    template <typename OtherLayout>
+    friend class BasicCompressor;
+};
+
+/**
+ * @brief The SerializedView allows to pop data from a payload it does not own.
+ * 
+ * Unlike the SerializedObject, constructing a SerializedView from a payload does not copy it,
+ * which makes it the go-to to unserialize straight from a reception buffer.\n
+ * The payload must outlive the SerializedView, and must not be modified while it is being popped from.\n
+ * SerializedView is the BasicSerializedView using DefaultLayout.
+ * @tparam Layout The layout of the viewed payload.
+ */
+template <typename Layout>
+class BasicSerializedView {
+public:
+    using LayoutType = Layout;
+
+    /**
+     * @brief Construct an empty view.
+     */
+    BasicSerializedView() = default;
+
+    /**
+     * @brief Construct view over a payload.
+     * 
+     * The size of the payload is read from its checksum.
+     * @param data payload the SerializedView will pop from.
+     * @throw PayloadError If the checksum is smaller than itself, or if the CRC of a Crc32cLayout does not match.
+     */
+    inline BasicSerializedView(const char* data)
+        : _data(data)
+        , _size(Layout::readChecksum(data))
+    {
+        if (_size < Layout::CHECKSUM_SIZE)
+            throw PayloadError("bas: payload size does not match its checksum");
+        if (!Layout::verifyChecksum(data, _size))
+            throw PayloadError("bas: payload CRC mismatch");
+    }
+
+    /**
+     * @brief Construct view over a payload of known size.
+     * 
+     * The CRC of a Crc32cLayout is not verified, use BasicSerializedView(const char*) for a payload
+     * received from the outside.
+     * @param data payload the SerializedView will pop from.
+     * @param size The size of the payload in Bytes, checksum included.
+     */
+    inline BasicSerializedView(const char* data, size_t size)
+        : _data(data)
+        , _size(size)
+    {
+    }
+
+    /**
+     * @brief Construct view over the payload of a SerializedObject.
+     * 
+     * The view is invalidated by any modification of obj.
+     * Calls obj.payload(), see finalize() to build views of obj from several threads at once.
+     * @param obj SerializedObject to pop from.
+     */
+    inline BasicSerializedView(const BasicSerializedObject<Layout>& obj)
+        : _data(obj.payload())
+        , _size(obj.size())
+    {
+    }
+
+    /**
+     * @brief Unserializes a Reflectable object nested in the payload, without copying anything.
+     * 
+     * The child pops from a view over the nested payload only.
+     * @param child The object to be unserialized.
+     * @throw PayloadError If the child does not pop exactly the nested payload.
+     * @see BasicSerializedObject::popObject()
+     */
+    template <typename Child>
+    inline void popObject(Child& child)
+    {
+        BasicSerializedView nested = popData<BasicSerializedView>();
+
+        if (nested._size < Layout::CHECKSUM_SIZE || Layout::readChecksum(nested._data) != nested._size)
+            throw PayloadError("bas: nested object does not match its size");
+        nested.rewind();
+        child.makeUnserialization(nested);
+        if (nested.remaining() != 0)
+            throw PayloadError("bas: nested object does not match its size");
+    }
+
+    /**
+     * @brief Pop the next data in the payload.
+     *
+     * @return The popped value from the payload.
+     * @see SerializedObject::popData<>()
+     */
+    template <typename T>
+    inline T popData(void)
+    {
+        Helper<T> helper;
+        return helper.popData(*this);
+    }
+
+    /**
+     * @brief Pop the next array in the payload and returns a PoppedArray.
+     * 
+     * @see SerializedObject::popDataArray<>()
+     */
+    template <typename T>
+    inline PoppedArray<T> popDataArray(void)
+    {
+        size_t size = 0;
+        size_t array_size = 0;
+        T* var;
+
+        std::tie(size, array_size) = getSizes();
+
+        var = new T[array_size];
+
+        copyMem(size, array_size, var);
+
+        return PoppedArray<T>(array_size, var);
+    }
+
+    /**
+     * @brief Pop the next array in the payload without copying it when possible.
+     * 
+     * If the popped array is suitably aligned in the payload, the returned PoppedSpan
+     * points directly into the payload, otherwise it holds a single copy of the array.
+     * @see PoppedSpan
+     */
+    template <typename T>
+    inline PoppedSpan<T> popDataSpan(void)
+    {
+        Helper<PoppedSpan<T>> helper;
+        return helper.popData(*this);
+    }
+
+    /**
+     * @brief Pop the next array pushed with pushDataEncoded(), whatever its codec.
+     * @throw PayloadError If the encoded array is malformed.
+     */
+    template <typename T>
+    inline std::vector<T> popDataEncoded(void)
+    {
+        size_t size = 0;
+        size_t array_size = 0;
+
+        std::tie(size, array_size) = getSizes();
+        return Codecs::decodeArray<Layout, T>(readData(size * array_size), size * array_size);
+    }
+
+    /**
+     * @brief Move the read cursor back to the first data of the payload.
+     */
+    inline void rewind(void)
+    {
+        _readOffset = Layout::CHECKSUM_SIZE;
+    }
+
+    /**
+     * @brief Returns a pointer to the viewed payload.
+     */
+    inline const char* payload(void) const
+    {
+        return _data;
+    }
+
+    /**
+     * @brief Returns the size of the viewed payload in Bytes.
+     */
+    inline size_t size(void) const
+    {
+        return _size;
+    }
+
+private:
+    inline const char* readPointer(void) const
+    {
+        return _data + _readOffset;
+    }
+
+    inline size_t remaining(void) const
+    {
+        return _size > _readOffset ? _size - _readOffset : 0;
+    }
+
+    inline const char* readData(size_t size)
+    {
+        const char* data = _data + _readOffset;
+
+        if (size > remaining())
+            throw PayloadError("bas: data popped past the end of the payload");
+        _readOffset += size;
+        return data;
+    }
+
+    inline std::tuple<size_t, size_t> getSizes(void)
+    {
+        size_t size = 0, array_size = 0;
+
+        readData(readBoundedSizes<Layout>(readPointer(), remaining(), size, array_size));
+        return std::make_tuple(size, array_size);
+    }
+
+    template <typename T>
+    inline void copyMem(size_t size, size_t array_size, T* var)
+    {
+        const char* data = readData(size * array_size);
+
+        if (array_size == 0)
+            return;
+        if constexpr (Layout::SWAP_BYTES && Wire::isSwappable<T>) {
+            if (size == sizeof(T)) {
+                Wire::swapBytes<sizeof(T)>((char*)var, data, array_size);
+                return;
+            }
+        }
+        if (size == sizeof(T)) {
+            std::memcpy(var, data, size * array_size);
+        } else {
+            for (size_t j = 0; j < array_size; j++)
+                std::memcpy(var + j, data + j * size, size < sizeof(T) ? size : sizeof(T));
+        }
+    }
+
+    const char* _data = nullptr;
+    size_t _size = 0;
+    size_t _readOffset = Layout::CHECKSUM_SIZE; // Position of the next data to be popped
+
+    template <typename T>
+    friend class Helper;
+    template <typename OtherLayout>
+    friend class BasicFieldIndex;
+};
+
+/**
+ * @brief The StreamFramer cuts a stream of bytes, received in chunks of any size, into payloads.
+ * 
+ * The checksum at the beginning of each payload is its length, the StreamFramer uses it to find
+ * where each payload ends. Chunks are fed as they are received with feed(), then next()
+ * is called until it returns false to get every complete payload.\n
+ * A payload entirely contained in a chunk is returned as a view into the chunk, without copying it.
+ * Only the payloads split across chunks are buffered, and the buffer is kept from one payload to the next.\n
+ * The payloads returned by next() are valid until the next call to next(), feed() or reset().
+ * The chunk passed to feed() must stay valid until next() returns false.
+ * @code
+bas::StreamFramer framer;
+bas::SerializedView frame;
+char chunk[4096];
+
+while ((n = recv(fd, chunk, sizeof(chunk), 0)) > 0) {
+    framer.feed(chunk, n);
+    while (framer.next(frame))
+        handle(frame);
+}
+ * @endcode
+ * StreamFramer is the BasicStreamFramer using DefaultLayout.
+ * @tparam Layout The layout of the received payloads.
+ */
+template <typename Layout>
+class BasicStreamFramer {
+public:
+    using LayoutType = Layout;
+
+    /**
+     * @brief Construct a StreamFramer.
+     * @param maxFrameSize The maximum size of a payload in Bytes, checksum included.
+     * @param resource The memory resource the buffer of split payloads is allocated from.
+     */
+    explicit inline BasicStreamFramer(size_t maxFrameSize = _BAS_MAX_FRAME_SIZE_, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : _buffer(resource)
+        , _maxFrameSize(maxFrameSize)
+    {
+    }
+
+    /**
+     * @brief Feed the next chunk of the stream.
+     * 
+     * Nothing is copied unless a payload is split across chunks.
+     * If the previous chunk was not consumed by next(), what is left of it is buffered.
+     * @param data The received Bytes.
+     * @param size The number of received Bytes.
+     */
+    inline void feed(const char* data, size_t size)
+    {
+        stash();
+        _chunk = data;
+        _chunkSize = size;
+    }
+
+    /**
+     * @brief Get the next complete payload of the stream.
+     * @param frame The view set on the payload.
+     * @return true if a payload was complete, false if more Bytes must be fed.
+     * @throw PayloadError If the checksum of the payload is smaller than itself or bigger than maxFrameSize().
+     * The stream cannot be recovered, the StreamFramer must be reset().
+     * If the CRC of a Crc32cLayout does not match, the payload is skipped and the next one can be read.
+     */
+    inline bool next(BasicSerializedView<Layout>& frame)
+    {
+        if (!nextFrame(frame))
+            return false;
+        if (!Layout::verifyChecksum(frame.payload(), frame.size()))
+            throw PayloadError("bas: payload CRC mismatch");
+        return true;
+    }
+
+    /**
+     * @brief Get a copy of the next complete payload of the stream.
+     * 
+     * The copy is allocated from the memory resource of obj.
+     * @param obj The SerializedObject assigned the payload.
+     * @return true if a payload was complete, false if more Bytes must be fed.
+     * @throw PayloadError If the checksum of the payload is smaller than itself or bigger than maxFrameSize(),
+     * or if the CRC of a Crc32cLayout does not match, as next(BasicSerializedView&).
+     */
+    inline bool next(BasicSerializedObject<Layout>& obj)
+    {
+        BasicSerializedView<Layout> frame;
+
+        if (!nextFrame(frame))
+            return false;
+        obj = BasicSerializedObject<Layout>(frame.payload(), frame.size(), obj.resource());
+        return true;
+    }
+
+    /**
+     * @brief Drop every buffered Byte, to start over on a new stream.
+     */
+    inline void reset(void)
+    {
+        _buffer.clear();
+        _offset = 0;
+        _chunk = nullptr;
+        _chunkSize = 0;
+    }
+
+    /**
+     * @brief Returns the number of Bytes fed and not returned by next() yet.
+     */
+    inline size_t pending(void) const
+    {
+        return _buffer.size() - _offset + _chunkSize;
+    }
+
+    /**
+     * @brief Returns the maximum size of a payload in Bytes, checksum included.
+     */
+    inline size_t maxFrameSize(void) const
+    {
+        return _maxFrameSize;
+    }
+
+private:
+    inline bool nextFrame(BasicSerializedView<Layout>& frame)
+    {
+        size_t size = 0;
+
+        if (_offset == _buffer.size()) {
+            _buffer.clear();
+            _offset = 0;
+        }
+
+        if (_buffer.empty()) {
+            if (_chunkSize < Layout::CHECKSUM_SIZE || _chunkSize < (size = frameSize(_chunk))) {
+                stash();
+                return false;
+            }
+            frame = BasicSerializedView<Layout>(_chunk, size);
+            _chunk += size;
+            _chunkSize -= size;
+            return true;
+        }
+
+        if (!fill(Layout::CHECKSUM_SIZE) || !fill(size = frameSize(_buffer.data() + _offset)))
+            return false;
+        frame = BasicSerializedView<Layout>(_buffer.data() + _offset, size);
+        _offset += size;
+        return true;
+    }
+
+    inline size_t frameSize(const char* data) const
+    {
+        size_t size = Layout::readChecksum(data);
+
+        if (size < Layout::CHECKSUM_SIZE || size > _maxFrameSize)
+            throw PayloadError("bas: payload size out of bounds");
+        return size;
+    }
+
+    inline void compact(void)
+    {
+        if (_offset == 0)
+            return;
+        _buffer.erase(_buffer.begin(), _buffer.begin() + _offset);
+        _offset = 0;
+    }
+
+    // Moves Bytes from the chunk to the buffer until size Bytes are buffered, returns false if the chunk runs out
+    inline bool fill(size_t size)
+    {
+        size_t buffered = _buffer.size() - _offset;
+
+        if (buffered < size && _chunkSize != 0) {
+            size_t count = size - buffered < _chunkSize ? size - buffered : _chunkSize;
+
+            compact();
+            _buffer.reserve(size);
+            _buffer.insert(_buffer.end(), _chunk, _chunk + count);
+            _chunk += count;
+            _chunkSize -= count;
+        }
+        return _buffer.size() - _offset >= size;
+    }
+
+    inline void stash(void)
+    {
+        if (_chunkSize == 0)
+            return;
+        compact();
+        _buffer.insert(_buffer.end(), _chunk, _chunk + _chunkSize);
+        _chunk += _chunkSize;
+        _chunkSize = 0;
+    }
+
+    Buffer _buffer; // Payloads split across chunks
+    size_t _offset = 0; // Position of the next payload in _buffer
+    const char* _chunk = nullptr;
+    size_t _chunkSize = 0;
+    size_t _maxFrameSize;
+};
+
+/**
+ * @brief The BatchWriter serializes many objects one after the other into a single payload.
+ * 
+ * Each record is a complete payload, checksum included, serialized in place at the end of the batch.
+ * finish() appends a table of the offsets of the records followed by their count, so that
+ * a BatchReader can access any record without reading the others:
+ * @code
+[checksum][record 0]...[record n - 1][offset 0]...[offset n - 1][n]
+ * @endcode
+ * Offsets and count are stored on Layout::LENGTH_SIZE Bytes.
+ * The batch is itself a payload, it can be sent or stored like any other SerializedObject.\n
+ * BatchWriter is the BasicBatchWriter using DefaultLayout.
+ * @tparam Layout The layout of the batch and of its records.
+ * @see BasicBatchReader
+ */
+template <typename Layout>
+class BasicBatchWriter {
+public:
+    using LayoutType = Layout;
+
+    /**
+     * @brief Construct an empty batch.
+     * @param resource The memory resource the batch is allocated from.
+     */
+    explicit inline BasicBatchWriter(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : _batch(resource)
+        , _offsets(resource)
+    {
+    }
+
+    /**
+     * @brief Serialize a Serializable or Reflectable object at the end of the batch.
+     * @param record The object to be serialized.
+     */
+    template <typename Record>
+    inline void push(Record& record)
+    {
+        size_t start = _batch._data.size();
+        size_t offset = _batch.size();
+
+        _offsets.push_back(offset);
+        _batch.extend(Layout::CHECKSUM_SIZE);
+        record.makeSerialization(_batch);
+        Layout::writeChecksum(_batch._data.data() + start, _batch.size() - offset);
+    }
+
+    /**
+     * @brief Copy an already serialized payload at the end of the batch.
+     * @param record The payload to be copied.
+     */
+    inline void pushPayload(const BasicSerializedObject<Layout>& record)
+    {
+        _offsets.push_back(_batch.size());
+        std::memcpy(_batch.extend(record.size()), record.payload(), record.size());
+    }
+
+    /**
+     * @brief Serialize the records of [first, last) at the end of the batch, on several threads.
+     * 
+     * The records are split in chunks serialized in parallel into separate buffers,
+     * which are then copied one after the other at the end of the batch, in parallel as well.
+     * The batch is the same as if every record had been pushed with push(), in order.\n
+     * The records must be Serializable or Reflectable objects, or pointers to them.
+     * Their makeSerialization() is called concurrently, so it must not modify shared state.
+     * @param first Random access iterator to the first record.
+     * @param last Random access iterator past the last record.
+     * @param threads The maximum number of threads, the calling thread included.
+     */
+    template <typename Iterator>
+    inline void pushParallel(Iterator first, Iterator last, size_t threads = defaultThreads())
+    {
+        size_t count = last - first;
+        size_t chunkSize = std::max<size_t>(count / (std::max<size_t>(threads, 1) * 4), 64);
+        std::vector<BasicBatchWriter> writers((count + chunkSize - 1) / chunkSize);
+        std::vector<size_t> starts(writers.size() + 1, 0);
+        size_t base = _batch.size();
+
+        if (threads <= 1 || writers.size() <= 1) {
+            for (; first != last; ++first)
+                pushRecord(*first);
+            return;
+        }
+        parallelChunks(count, chunkSize, threads, [&](size_t chunk, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++)
+                writers[chunk].pushRecord(first[i]);
+        });
+
+        // Prefix sum of the sizes of the chunks, without their checksum
+        for (size_t chunk = 0; chunk < writers.size(); chunk++) {
+            starts[chunk + 1] = starts[chunk] + writers[chunk].size() - Layout::CHECKSUM_SIZE;
+            for (size_t offset : writers[chunk]._offsets)
+                _offsets.push_back(base + starts[chunk] + offset - Layout::CHECKSUM_SIZE);
+        }
+
+        char* data = _batch.extend(starts.back());
+
+        parallelChunks(writers.size(), 1, threads, [&](size_t chunk, size_t, size_t) {
+            std::memcpy(data + starts[chunk], writers[chunk]._batch.payload() + Layout::CHECKSUM_SIZE, starts[chunk + 1] - starts[chunk]);
+        });
+    }
+
+    /**
+     * @brief Reserve memory for the records and the offset table.
+     * @param bytes The expected size of the records in Bytes.
+     * @param records The expected number of records.
+     */
+    inline void reserve(size_t bytes, size_t records)
+    {
+        _batch.reserve(Layout::CHECKSUM_SIZE + bytes + (records + 1) * Layout::LENGTH_SIZE);
+        _offsets.reserve(records);
+    }
+
+    /**
+     * @brief Returns the number of records pushed since the last call to finish().
+     */
+    inline size_t count(void) const
+    {
+        return _offsets.size();
+    }
+
+    /**
+     * @brief Returns the size in Bytes of the records pushed since the last call to finish(), checksum of the batch included.
+     */
+    inline size_t size(void) const
+    {
+        return _batch.size();
+    }
+
+    /**
+     * @brief Append the offset table and return the batch.
+     * 
+     * The BatchWriter is emptied and can be used for a new batch.
+     * @return The SerializedObject containing the batch.
+     */
+    inline BasicSerializedObject<Layout> finish(void)
+    {
+        char* table = _batch.extend((_offsets.size() + 1) * Layout::LENGTH_SIZE);
+
+        for (size_t offset : _offsets) {
+            Wire::store<Layout::LENGTH_SIZE>(table, offset);
+            table += Layout::LENGTH_SIZE;
+        }
+        Wire::store<Layout::LENGTH_SIZE>(table, _offsets.size());
+        _offsets.clear();
+
+        BasicSerializedObject<Layout> batch(std::move(_batch));
+
+        return batch;
+    }
+
+private:
+    template <typename Record>
+    inline void pushRecord(Record& record)
+    {
+        if constexpr (std::is_pointer_v<Record>)
+            push(*record);
+        else
+            push(record);
+    }
+
+    // Removes the last record from the batch and returns a copy of it, to be pushed into the next batch
+    inline BasicSerializedObject<Layout> popRecord(void)
+    {
+        size_t offset = _offsets.back();
+        BasicSerializedObject<Layout> record(_batch.payload() + offset, _batch.size() - offset);
+
+        _offsets.pop_back();
+        _batch._data.resize(offset);
+        _batch.checksumUpdate();
+        return record;
+    }
+
+    BasicSerializedObject<Layout> _batch;
+    std::pmr::vector<size_t> _offsets;
+
+    template <typename OtherLayout>
+    friend class BasicArchiveWriter;
+};
+
+/**
+ * @brief The BatchReader gives access to the records of a batch built by a BatchWriter, without copying them.
+ * 
+ * The offset table is checked once at construction, then each record is reached in constant time.
+ * The batch must outlive the BatchReader and the views it returns.\n
+ * BatchReader is the BasicBatchReader using DefaultLayout.
+ * @tparam Layout The layout of the batch and of its records.
+ * @see BasicBatchWriter
+ */
+template <typename Layout>
+class BasicBatchReader {
+public:
+    using LayoutType = Layout;
+
+    /**
+     * @brief Construct a reader over an empty batch.
+     */
+    BasicBatchReader() = default;
+
+    /**
+     * @brief Construct a reader over a batch received in a buffer of size Bytes.
+     * @param data The payload of the batch.
+     * @param size The number of Bytes available at data.
+     * @throw PayloadError If the batch or its offset table are malformed, or if the CRC of a Crc32cLayout does not match.
+     */
+    inline BasicBatchReader(const char* data, size_t size)
+        : _data(data)
+    {
+        size_t total = size < Layout::CHECKSUM_SIZE ? 0 : Layout::readChecksum(data);
+
+        if (total < Layout::CHECKSUM_SIZE + Layout::LENGTH_SIZE || total > size)
+            throw PayloadError("bas: batch size does not match its checksum");
+        if (!Layout::verifyChecksum(data, total))
+            throw PayloadError("bas: batch CRC mismatch");
+        _count = Wire::load<Layout::LENGTH_SIZE>(data + total - Layout::LENGTH_SIZE);
+        if (_count > (total - Layout::CHECKSUM_SIZE - Layout::LENGTH_SIZE) / Layout::LENGTH_SIZE)
+            throw PayloadError("bas: batch offset table out of bounds");
+        _tableOffset = total - (_count + 1) * Layout::LENGTH_SIZE;
+
+        for (size_t i = 0, end = Layout::CHECKSUM_SIZE; i < _count; i++) {
+            size_t offset = offsetOf(i);
+
+            if (offset < end || offset + Layout::CHECKSUM_SIZE > _tableOffset)
+                throw PayloadError("bas: batch offset table out of bounds");
+            end = offset + Layout::CHECKSUM_SIZE;
+        }
+    }
+
+    /**
+     * @brief Construct a reader over the batch returned by BatchWriter::finish().
+     * @param batch The batch to read from.
+     */
+    inline BasicBatchReader(const BasicSerializedObject<Layout>& batch)
+        : BasicBatchReader(batch.payload(), batch.size())
+    {
+    }
+
+    /**
+     * @brief Returns a view over the record at index.
+     * @param index The index of the record, which must be smaller than size().
+     */
+    inline BasicSerializedView<Layout> operator[](size_t index) const
+    {
+        size_t offset = offsetOf(index);
+        size_t end = index + 1 < _count ? offsetOf(index + 1) : _tableOffset;
+
+        return BasicSerializedView<Layout>(_data + offset, end - offset);
+    }
+
+    /**
+     * @brief Call function(index, view) for every record of the batch, on several threads.
+     * 
+     * The records are split in chunks of consecutive records, handed to the threads as they get free.
+     * @code
+reader.forEachParallel([&](size_t index, bas::SerializedView record) { entities[index].unserialize(record); });
+     * @endcode
+     * @param function The function called for each record, concurrently.
+     * @param threads The maximum number of threads, the calling thread included.
+     */
+    template <typename Function>
+    inline void forEachParallel(Function function, size_t threads = defaultThreads()) const
+    {
+        size_t chunkSize = std::max<size_t>(_count / (std::max<size_t>(threads, 1) * 4), 64);
+
+        parallelChunks(_count, chunkSize, threads, [&](size_t, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++)
+                function(i, (*this)[i]);
+        });
+    }
+
+    /**
+     * @brief Returns the number of records in the batch.
+     */
+    inline size_t size(void) const
+    {
+        return _count;
+    }
+
+private:
+    inline size_t offsetOf(size_t index) const
+    {
+        return Wire::load<Layout::LENGTH_SIZE>(_data + _tableOffset + index * Layout::LENGTH_SIZE);
+    }
+
+    const char* _data = nullptr;
+    size_t _count = 0;
+    size_t _tableOffset = 0; // Position of the offset table
+};
+
+/// \cond
+struct ArchiveFormat {
+    static constexpr char MAGIC[8] = { 'B', 'A', 'S', 'A', 'R', 'C', 'H', '1' };
+};
+/// \endcond
+
+/**
+ * @brief The ArchiveWriter stores records in a file, to be read back by an ArchiveReader.
+ * 
+ * The archive is a header followed by batches, as built by a BatchWriter.
+ * A batch is written to the file each time its size reaches the batch size given to the constructor,
+ * or before a record that would make the batch and its offset table bigger than Layout::LENGTH_SIZE Bytes can hold.\n
+ * The archive is read back with the same Layout it was written with.\n
+ * ArchiveWriter is the BasicArchiveWriter using DefaultLayout.
+ * @tparam Layout The layout of the batches and of the records.
+ * @see BasicArchiveReader
+ */
+template <typename Layout>
+class BasicArchiveWriter {
+public:
+    using LayoutType = Layout;
+
+    /// Biggest batch size, and biggest record, the size of a batch of one record and its offset table must fit in Layout::LENGTH_SIZE Bytes.
+    static constexpr size_t MAX_BATCH_SIZE = Wire::maxStored<Layout::LENGTH_SIZE>() - 2 * Layout::LENGTH_SIZE;
+
+    /**
+     * @brief Create or truncate the archive at path.
+     * @param path The path of the archive.
+     * @param batchSize The size in Bytes from which a batch is written to the file, at most MAX_BATCH_SIZE.
+     * @throw std::invalid_argument If batchSize is bigger than MAX_BATCH_SIZE, the file is left untouched.
+     * @throw std::system_error If the file cannot be opened.
+     */
+    explicit inline BasicArchiveWriter(const std::string& path, size_t batchSize = 16777216)
+        : _file(nullptr)
+        , _batchSize(batchSize)
+    {
+        if (batchSize > MAX_BATCH_SIZE)
+            throw std::invalid_argument("bas: the batch size of the archive does not fit the length of the layout");
+        _file = std::fopen(path.c_str(), "wb");
+        if (!_file)
+            throw std::system_error(errno, std::generic_category(), "bas: cannot open " + path);
+        write(ArchiveFormat::MAGIC, sizeof(ArchiveFormat::MAGIC));
+    }
+
+    BasicArchiveWriter(const BasicArchiveWriter&) = delete;
+    BasicArchiveWriter& operator=(const BasicArchiveWriter&) = delete;
+
+    /**
+     * @brief Write the last batch and close the archive, errors are ignored.
+     * @see close()
+     */
+    inline ~BasicArchiveWriter()
+    {
+        try {
+            close();
+        } catch (const std::exception&) {
+        }
+    }
+
+    /**
+     * @brief Serialize a Serializable or Reflectable object into the archive.
+     * 
+     * The record is serialized at the end of the current batch. If the batch then no longer fits
+     * Layout::LENGTH_SIZE Bytes, the record is moved to the next batch.
+     * @param record The object to be serialized.
+     * @throw std::invalid_argument If the serialized record is bigger than MAX_BATCH_SIZE - Layout::CHECKSUM_SIZE.
+     * @throw std::system_error If a batch cannot be written.
+     */
+    template <typename Record>
+    inline void push(Record& record)
+    {
+        _writer.push(record);
+        if (!fits(_writer.size(), _writer.count())) {
+            pushPayload(_writer.popRecord());
+            return;
+        }
+        if (_writer.size() >= _batchSize)
+            flush();
+    }
+
+    /**
+     * @brief Copy an already serialized payload into the archive.
+     * 
+     * The current batch is written first if the record would make it no longer fit Layout::LENGTH_SIZE Bytes.
+     * @param record The payload to be copied.
+     * @throw std::invalid_argument If record is bigger than MAX_BATCH_SIZE - Layout::CHECKSUM_SIZE.
+     * @throw std::system_error If a batch cannot be written.
+     */
+    inline void pushPayload(const BasicSerializedObject<Layout>& record)
+    {
+        if (!fits(Layout::CHECKSUM_SIZE + record.size(), 1))
+            throw std::invalid_argument("bas: the record does not fit in a batch of the layout");
+        if (!fits(_writer.size() + record.size(), _writer.count() + 1))
+            flush();
+        _writer.pushPayload(record);
+        if (_writer.size() >= _batchSize)
+            flush();
+    }
+
+    /**
+     * @brief Write the current batch to the file, even if it is not full.
+     * @throw std::system_error If the batch cannot be written.
+     */
+    inline void flush(void)
+    {
+        if (_writer.count() == 0)
+            return;
+
+        BasicSerializedObject<Layout> batch = _writer.finish();
+
+        write(batch.payload(), batch.size());
+    }
+
+    /**
+     * @brief Write the last batch and close the archive.
+     * @throw std::system_error If the batch cannot be written or the file cannot be closed.
+     */
+    inline void close(void)
+    {
+        if (!_file)
+            return;
+        flush();
+
+        std::FILE* file = _file;
+
+        _file = nullptr;
+        if (std::fclose(file) != 0)
+            throw std::system_error(errno, std::generic_category(), "bas: cannot close archive");
+    }
+
+private:
+    // True if a batch of count records taking size Bytes fits, with its offset table, in Layout::LENGTH_SIZE Bytes
+    static constexpr bool fits(size_t size, size_t count)
+    {
+        return size + (count + 1) * Layout::LENGTH_SIZE <= Wire::maxStored<Layout::LENGTH_SIZE>();
+    }
+
+    inline void write(const char* data, size_t size)
+    {
+        if (std::fwrite(data, 1, size, _file) != size)
+            throw std::system_error(errno, std::generic_category(), "bas: cannot write archive");
+    }
+
+    std::FILE* _file;
+    size_t _batchSize;
+    BasicBatchWriter<Layout> _writer;
+};
+
+#ifdef _BAS_HAS_MMAP_
+/**
+ * @brief The ArchiveReader maps an archive written by an ArchiveWriter in memory, and gives access to its records.
+ * 
+ * Nothing is read from the file but the offset tables of the batches when the archive is opened,
+ * the records are popped straight from the mapping, and only the pages they are on are loaded.\n
+ * The views returned by the ArchiveReader are valid as long as it is.\n
+ * ArchiveReader is the BasicArchiveReader using DefaultLayout.
+ * @tparam Layout The layout the archive was written with.
+ * @see BasicArchiveWriter
+ */
+template <typename Layout>
+class BasicArchiveReader {
+public:
+    using LayoutType = Layout;
+
+    /**
+     * @brief Map the archive at path.
+     * @param path The path of the archive.
+     * @throw std::system_error If the file cannot be opened or mapped.
+     * @throw PayloadError If the file is not an archive, or is corrupted, or if the CRC of a batch of a Crc32cLayout does not match.
+     */
+    explicit inline BasicArchiveReader(const std::string& path)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        struct stat st;
+
+        if (fd < 0)
+            throw std::system_error(errno, std::generic_category(), "bas: cannot open " + path);
+        if (::fstat(fd, &st) < 0) {
+            int error = errno;
+
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(), "bas: cannot open " + path);
+        }
+        _size = st.st_size;
+
+        void* data = _size ? ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0) : nullptr;
+        int error = errno;
+
+        ::close(fd);
+        if (data == MAP_FAILED)
+            throw std::system_error(error, std::generic_category(), "bas: cannot map " + path);
+        _data = (const char*)data;
+        try {
+            index();
+        } catch (...) {
+            unmap();
+            throw;
+        }
+    }
+
+    inline BasicArchiveReader(BasicArchiveReader&& other) noexcept
+        : _data(std::exchange(other._data, nullptr))
+        , _size(std::exchange(other._size, 0))
+        , _count(std::exchange(other._count, 0))
+        , _batches(std::move(other._batches))
+        , _firsts(std::move(other._firsts))
+    {
+    }
+
+    inline BasicArchiveReader& operator=(BasicArchiveReader&& other) noexcept
+    {
+        if (this != &other) {
+            unmap();
+            _data = std::exchange(other._data, nullptr);
+            _size = std::exchange(other._size, 0);
+            _count = std::exchange(other._count, 0);
+            _batches = std::move(other._batches);
+            _firsts = std::move(other._firsts);
+        }
+        return *this;
+    }
+
+    BasicArchiveReader(const BasicArchiveReader&) = delete;
+    BasicArchiveReader& operator=(const BasicArchiveReader&) = delete;
+
+    /**
+     * @brief Unmap the archive.
+     */
+    inline ~BasicArchiveReader()
+    {
+        unmap();
+    }
+
+    /**
+     * @brief Returns a view over the record at index, in the order the records were pushed.
+     * @param index The index of the record, which must be smaller than size().
+     */
+    inline BasicSerializedView<Layout> operator[](size_t index) const
+    {
+        size_t batch = std::upper_bound(_firsts.begin(), _firsts.end(), index) - _firsts.begin() - 1;
+
+        return _batches[batch][index - _firsts[batch]];
+    }
+
+    /**
+     * @brief Returns the number of records in the archive.
+     */
+    inline size_t size(void) const
+    {
+        return _count;
+    }
+
+    /**
+     * @brief Returns the number of batches in the archive.
+     */
+    inline size_t batchCount(void) const
+    {
+        return _batches.size();
+    }
+
+    /**
+     * @brief Returns the batch at index, to go through the records of the archive batch by batch.
+     * @param index The index of the batch, which must be smaller than batchCount().
+     */
+    inline const BasicBatchReader<Layout>& batch(size_t index) const
+    {
+        return _batches[index];
+    }
+
+private:
+    inline void index(void)
+    {
+        size_t offset = sizeof(ArchiveFormat::MAGIC);
+
+        if (_size < offset || std::memcmp(_data, ArchiveFormat::MAGIC, offset) != 0)
+            throw PayloadError("bas: not an archive");
+        while (offset < _size) {
+            BasicBatchReader<Layout> batch(_data + offset, _size - offset);
+
+            _firsts.push_back(_count);
+            _batches.push_back(batch);
+            _count += batch.size();
+            offset += Layout::readChecksum(_data + offset);
+        }
+    }
+
+    inline void unmap(void)
+    {
+        if (_data)
+            ::munmap(const_cast<char*>(_data), _size);
+        _data = nullptr;
+    }
+
+    const char* _data = nullptr;
+    size_t _size = 0;
+    size_t _count = 0;
+    std::vector<BasicBatchReader<Layout>> _batches;
+    std::vector<size_t> _firsts; // Index of the first record of each batch
+};
+#endif
+
+/**
+ * @brief Sizes and durations accumulated by a BasicCompressor.
+ */
+struct CompressionStats {
+    size_t compressedPayloads = 0;
+    size_t decompressedPayloads = 0;
+    size_t rawBytes = 0; ///< Bytes of the payloads given to compress()
+    size_t compressedBytes = 0; ///< Bytes of the payloads returned by compress(), header included
+    size_t decompressedBytes = 0; ///< Bytes of the payloads returned by decompress()
+    double compressSeconds = 0;
+    double decompressSeconds = 0;
+
+    /**
+     * @brief Returns the compression ratio, raw size over compressed size.
+     */
+    inline double ratio(void) const
+    {
+        return compressedBytes != 0 ? double(rawBytes) / compressedBytes : 0;
+    }
+
+    /**
+     * @brief Returns the throughput of compress(), in raw Bytes per second.
+     */
+    inline double compressThroughput(void) const
+    {
+        return compressSeconds > 0 ? rawBytes / compressSeconds : 0;
+    }
+
+    /**
+     * @brief Returns the throughput of decompress(), in decompressed Bytes per second.
+     */
+    inline double decompressThroughput(void) const
+    {
+        return decompressSeconds > 0 ? decompressedBytes / decompressSeconds : 0;
+    }
+};
+
+/**
+ * @brief The Compressor compresses whole payloads, to send them over slow links.
+ * 
+ * A compressed payload is itself a payload, which can be framed, batched or archived like any other:
+ * @code
+[checksum][codec][size of the payload][encoded payload]
+ * @endcode
+ * The codec Byte tells decompress() how the payload was encoded, so that payloads compressed
+ * with different codecs can be mixed. A payload that does not shrink is stored with Codec::None.\n
+ * Compressor is the BasicCompressor using DefaultLayout.
+ * @tparam Layout The layout of the compressed payloads and of the payloads they contain.
+ */
+template <typename Layout>
+class BasicCompressor {
+public:
+    using LayoutType = Layout;
+
+    /**
+     * @brief Construct a Compressor.
+     * @param codec The codec used by compress(): Codec::Lz, Codec::Rle, or Codec::None to only add the header.
+     * @param maxSize The maximum size of a decompressed payload in Bytes, checksum included.
+     * @throw std::invalid_argument If codec is Codec::Delta, which only applies to arrays of integers.
+     */
+    explicit inline BasicCompressor(Codec codec = Codec::Lz, size_t maxSize = _BAS_MAX_FRAME_SIZE_)
+        : _codec(codec)
+        , _maxSize(maxSize)
+    {
+        if (codec != Codec::None && codec != Codec::Rle && codec != Codec::Lz)
+            throw std::invalid_argument("bas: payloads can only be compressed with Codec::None, Codec::Rle or Codec::Lz");
+    }
+
+    /**
+     * @brief Compress the payload of obj.
+     * @param obj The object to compress.
+     * @return The compressed payload, allocated from the memory resource of obj.
+     */
+    inline BasicSerializedObject<Layout> compress(const BasicSerializedObject<Layout>& obj)
+    {
+        BasicSerializedObject<Layout> compressed(obj.resource());
+
+        compress(obj.payload(), obj.size(), compressed);
+        return compressed;
+    }
+
+    /**
+     * @brief Compress a payload into compressed, reusing its allocation.
+     * @param data The payload to compress.
+     * @param size The size of the payload in Bytes, checksum included.
+     * @param compressed The SerializedObject assigned the compressed payload.
+     */
+    inline void compress(const char* data, size_t size, BasicSerializedObject<Layout>& compressed)
+    {
+        auto start = std::chrono::steady_clock::now();
+        Buffer& out = compressed._data;
+        Codec codec = _codec;
+        size_t header;
+
+        compressed.clear();
+        out.append(1 + Wire::MAX_VARINT_LENGTH);
+        header = Layout::CHECKSUM_SIZE + 1 + Wire::writeVarint(out.data() + Layout::CHECKSUM_SIZE + 1, size);
+        out.resize(header);
+        if (codec == Codec::Rle)
+            Codecs::encodeRle(out, data, size, 1);
+        else if (codec == Codec::Lz)
+            Codecs::encodeLz(out, data, size);
+        if (codec == Codec::None || out.size() - header >= size) {
+            codec = Codec::None;
+            out.resize(header);
+            std::memcpy(out.append(size), data, size);
+        }
+        out[Layout::CHECKSUM_SIZE] = static_cast<char>(codec);
+        compressed.writeChecksum();
+
+        _stats.compressedPayloads++;
+        _stats.rawBytes += size;
+        _stats.compressedBytes += out.size();
+        _stats.compressSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    /**
+     * @brief Decompress a compressed payload.
+     * @param compressed The compressed payload, as returned by compress().
+     * @return The decompressed payload, allocated from the default memory resource.
+     * @throw PayloadError If the compressed payload is malformed or bigger than maxSize.
+     */
+    inline BasicSerializedObject<Layout> decompress(const BasicSerializedView<Layout>& compressed)
+    {
+        BasicSerializedObject<Layout> obj;
+
+        decompress(compressed.payload(), compressed.size(), obj);
+        return obj;
+    }
+
+    /**
+     * @brief Decompress a compressed payload into obj, reusing its allocation.
+     * @param data The compressed payload, as returned by compress().
+     * @param size The size of the compressed payload in Bytes, checksum included.
+     * @param obj The SerializedObject assigned the decompressed payload.
+     * @throw PayloadError If the compressed payload is malformed or bigger than maxSize.
+     */
+    inline void decompress(const char* data, size_t size, BasicSerializedObject<Layout>& obj)
+    {
+        auto start = std::chrono::steady_clock::now();
+        const char* end = data + size;
+
+        if (size <= Layout::CHECKSUM_SIZE || Layout::readChecksum(data) != size)
+            throw PayloadError("bas: compressed payload size does not match its checksum");
+        data += Layout::CHECKSUM_SIZE;
+        Codec codec = static_cast<Codec>(*data++);
+        size_t rawSize = Codecs::readVarint(data, end);
+
+        if (rawSize < Layout::CHECKSUM_SIZE || rawSize > _maxSize)
+            throw PayloadError("bas: compressed payload size out of bounds");
+        obj.clear();
+        obj._data.clear();
+        char* out = obj._data.append(rawSize);
+
+        switch (codec) {
+        case Codec::None:
+            if (static_cast<size_t>(end - data) != rawSize)
+                throw PayloadError("bas: malformed encoded data");
+            std::memcpy(out, data, rawSize);
+            break;
+        case Codec::Rle:
+            Codecs::decodeRle(data, end, out, rawSize, 1);
+            break;
+        case Codec::Lz:
+            Codecs::decodeLz(data, end, out, rawSize);
+            break;
+        default:
+            throw PayloadError("bas: unknown codec");
+        }
+        if (Layout::readChecksum(out) != rawSize || !Layout::verifyChecksum(out, rawSize))
+            throw PayloadError("bas: decompressed payload does not match its checksum");
+        obj._isChecksumOutdated = false;
+
+        _stats.decompressedPayloads++;
+        _stats.decompressedBytes += rawSize;
+        _stats.decompressSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    /**
+     * @brief Returns the sizes and durations of the payloads compressed and decompressed so far.
+     */
+    inline const CompressionStats& stats(void) const
+    {
+        return _stats;
+    }
+
+    inline void resetStats(void)
+    {
+        _stats = CompressionStats();
+    }
+
+private:
+    Codec _codec;
+    size_t _maxSize;
+    CompressionStats _stats;
+};
+
+/// \cond
+struct QueueRing {
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    static inline size_t capacityOf(size_t capacity)
+    {
+        size_t power = 1;
+
+        while (power < capacity)
+            power <<= 1;
+        return power;
+    }
+};
+/// \endcond
+
+/**
+ * @brief The SpscQueue hands SerializedObjects from one producer thread to one consumer thread without locking.
+ * 
+ * The queue is a bounded ring of SerializedObjects: tryPush() moves an object into the ring and tryPop()
+ * moves it out, so that the payload changes hands without being copied, as long as it is allocated
+ * from a memory resource equal to the one of the queue. Neither ever blocks, they return false
+ * when the queue is full or empty.\n
+ * tryPop(objs, count) and consume() take many objects at once, with a single synchronization with the producer.\n
+ * SpscQueue is the BasicSpscQueue using DefaultLayout.
+ * @tparam Layout The layout of the queued objects.
+ * @see BasicMpscQueue
+ */
+template <typename Layout>
+class BasicSpscQueue {
+public:
+    using LayoutType = Layout;
+
+    /**
+     * @brief Construct an empty queue.
+     * @param capacity The maximum number of queued objects, rounded up to a power of two.
+     * @param resource The memory resource of the objects in the queue.
+     */
+    explicit inline BasicSpscQueue(size_t capacity, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : _mask(QueueRing::capacityOf(capacity) - 1)
+    {
+        _slots.reserve(_mask + 1);
+        for (size_t i = 0; i <= _mask; i++)
+            _slots.emplace_back(resource);
+    }
+
+    /**
+     * @brief Move obj at the end of the queue, only called by the producer thread.
+     * @param obj The object to queue, left empty if it was queued.
+     * @return false if the queue is full, obj is then left untouched.
+     */
+    inline bool tryPush(BasicSerializedObject<Layout>&& obj)
+    {
+        size_t tail = _tail.load(std::memory_order_relaxed);
+
+        if (tail - _cachedHead > _mask) {
+            _cachedHead = _head.load(std::memory_order_acquire);
+            if (tail - _cachedHead > _mask)
+                return false;
+        }
+        _slots[tail & _mask] = std::move(obj);
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Move the first object of the queue into obj, only called by the consumer thread.
+     * @return false if the queue is empty.
+     */
+    inline bool tryPop(BasicSerializedObject<Layout>& obj)
+    {
+        return tryPop(&obj, 1) == 1;
+    }
+
+    /**
+     * @brief Move up to count objects from the front of the queue into objs, only called by the consumer thread.
+     * @return The number of popped objects.
+     */
+    inline size_t tryPop(BasicSerializedObject<Layout>* objs, size_t count)
+    {
+        return consume([&objs](BasicSerializedObject<Layout>& obj) { *objs++ = std::move(obj); }, count);
+    }
+
+    /**
+     * @brief Call function on up to max objects from the front of the queue, and remove them, only called by the consumer thread.
+     * 
+     * The objects are passed in place, so that their payloads can be sent without moving them out of the queue.
+     * If function throws, the object it was called on is removed as well.
+     * @param function Called with a reference to each object.
+     * @param max The maximum number of objects to consume.
+     * @return The number of consumed objects.
+     */
+    template <typename Function>
+    inline size_t consume(Function&& function, size_t max = std::numeric_limits<size_t>::max())
+    {
+        size_t head = _head.load(std::memory_order_relaxed);
+        size_t count;
+        size_t i = 0;
+
+        if (_cachedTail - head < max)
+            _cachedTail = _tail.load(std::memory_order_acquire);
+        count = std::min(max, _cachedTail - head);
+        try {
+            for (; i < count; i++)
+                function(_slots[(head + i) & _mask]);
+        } catch (...) {
+            _head.store(head + i + 1, std::memory_order_release);
+            throw;
+        }
+        _head.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+    /**
+     * @brief Returns the number of queued objects, which may already have changed if called from another thread.
+     */
+    inline size_t size(void) const
+    {
+        size_t head = _head.load(std::memory_order_acquire);
+
+        return _tail.load(std::memory_order_acquire) - head;
+    }
+
+    inline bool empty(void) const
+    {
+        return size() == 0;
+    }
+
+    inline size_t capacity(void) const
+    {
+        return _mask + 1;
+    }
+
+private:
+    size_t _mask;
+    std::vector<BasicSerializedObject<Layout>> _slots;
+    alignas(QueueRing::CACHE_LINE_SIZE) std::atomic<size_t> _head { 0 }; // Written by the consumer
+    size_t _cachedTail = 0;
+    alignas(QueueRing::CACHE_LINE_SIZE) std::atomic<size_t> _tail { 0 }; // Written by the producer
+    size_t _cachedHead = 0;
+};
+
+/**
+ * @brief The MpscQueue hands SerializedObjects from many producer threads to one consumer thread without locking.
+ * 
+ * Same as the SpscQueue, except that tryPush() can be called from any number of threads.
+ * Each slot of the ring holds a sequence number telling whether it is free or holds a pushed object,
+ * producers claim slots by incrementing the tail of the queue with a compare and swap.\n
+ * MpscQueue is the BasicMpscQueue using DefaultLayout.
+ * @tparam Layout The layout of the queued objects.
+ * @see BasicSpscQueue
+ */
+template <typename Layout>
+class BasicMpscQueue {
+public:
+    using LayoutType = Layout;
+
+    /**
+     * @brief Construct an empty queue.
+     * @param capacity The maximum number of queued objects, rounded up to a power of two.
+     * @param resource The memory resource of the objects in the queue.
+     */
+    explicit inline BasicMpscQueue(size_t capacity, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : _mask(QueueRing::capacityOf(capacity) - 1)
+        , _sequences(new std::atomic<size_t>[_mask + 1])
+    {
+        _slots.reserve(_mask + 1);
+        for (size_t i = 0; i <= _mask; i++) {
+            _slots.emplace_back(resource);
+            _sequences[i].store(i, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Move obj at the end of the queue, from any thread.
+     * @param obj The object to queue, left empty if it was queued.
+     * @return false if the queue is full, obj is then left untouched.
+     */
+    inline bool tryPush(BasicSerializedObject<Layout>&& obj)
+    {
+        size_t tail = _tail.load(std::memory_order_relaxed);
+
+        while (true) {
+            size_t sequence = _sequences[tail & _mask].load(std::memory_order_acquire);
+            std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(sequence - tail);
+
+            if (difference < 0)
+                return false; // The slot still holds the object pushed one lap ago
+            if (difference == 0 && _tail.compare_exchange_weak(tail, tail + 1, std::memory_order_relaxed))
+                break;
+            if (difference > 0)
+                tail = _tail.load(std::memory_order_relaxed);
+        }
+        _slots[tail & _mask] = std::move(obj);
+        _sequences[tail & _mask].store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Move the first object of the queue into obj, only called by the consumer thread.
+     * @return false if the queue is empty.
+     */
+    inline bool tryPop(BasicSerializedObject<Layout>& obj)
+    {
+        return tryPop(&obj, 1) == 1;
+    }
+
+    /**
+     * @brief Move up to count objects from the front of the queue into objs, only called by the consumer thread.
+     * @return The number of popped objects.
+     */
+    inline size_t tryPop(BasicSerializedObject<Layout>* objs, size_t count)
+    {
+        return consume([&objs](BasicSerializedObject<Layout>& obj) { *objs++ = std::move(obj); }, count);
+    }
+
+    /**
+     * @brief Call function on up to max objects from the front of the queue, and remove them, only called by the consumer thread.
+     * 
+     * Consumption stops at the first slot claimed by a producer which has not finished pushing yet.
+     * @see BasicSpscQueue::consume()
+     */
+    template <typename Function>
+    inline size_t consume(Function&& function, size_t max = std::numeric_limits<size_t>::max())
+    {
+        size_t head = _head.load(std::memory_order_relaxed);
+        size_t count = 0;
+
+        for (; count < max; count++, head++) {
+            std::atomic<size_t>& sequence = _sequences[head & _mask];
+
+            if (sequence.load(std::memory_order_acquire) != head + 1)
+                break;
+            try {
+                function(_slots[head & _mask]);
+            } catch (...) {
+                sequence.store(head + _mask + 1, std::memory_order_release);
+                _head.store(head + 1, std::memory_order_relaxed);
+                throw;
+            }
+            sequence.store(head + _mask + 1, std::memory_order_release);
+        }
+        _head.store(head, std::memory_order_relaxed);
+        return count;
+    }
+
+    /**
+     * @brief Returns the number of queued objects, which may already have changed if called from another thread.
+     * 
+     * Objects being pushed are counted.
+     */
+    inline size_t size(void) const
+    {
+        size_t head = _head.load(std::memory_order_relaxed);
+
+        return _tail.load(std::memory_order_relaxed) - head;
+    }
+
+    inline bool empty(void) const
+    {
+        return size() == 0;
+    }
+
+    inline size_t capacity(void) const
+    {
+        return _mask + 1;
+    }
+
+private:
+    size_t _mask;
+    std::vector<BasicSerializedObject<Layout>> _slots;
+    std::unique_ptr<std::atomic<size_t>[]> _sequences; // Position of the next push into each slot, plus one once pushed
+    alignas(QueueRing::CACHE_LINE_SIZE) std::atomic<size_t> _head { 0 }; // Written by the consumer
+    alignas(QueueRing::CACHE_LINE_SIZE) std::atomic<size_t> _tail { 0 }; // Claimed by the producers
+};
+
+/**
+ * @brief The ObjectPool recycles SerializedObjects, so that serializing many payloads reuses warm buffers.
+ * 
+ * acquire() returns an empty SerializedObject, with the capacity it had when it was release()d,
+ * so that in steady state, serializing a payload does not allocate.
+ * Each thread has its own cache of objects, accessed without locking. A thread whose cache is full
+ * moves half of it to a list shared by all threads, and a thread whose cache is empty takes objects back
+ * from the shared list, so that objects released by one thread, for instance after being sent,
+ * are reused by the threads acquiring them.\n
+ * The cache of a thread which exits goes back to the shared list. The memory resource must outlive
+ * the pool and the threads using it.\n
+ * ObjectPool is the BasicObjectPool using DefaultLayout.
+ * @tparam Layout The layout of the pooled objects.
+ * @see Serializable::serialize(SerializedObject&)
+ */
+template <typename Layout>
+class BasicObjectPool {
+public:
+    using LayoutType = Layout;
+
+    /**
+     * @brief Construct an empty pool.
+     * @param cacheSize The maximum number of objects in the cache of each thread.
+     * @param maxShared The maximum number of objects in the shared list, more released objects are destroyed.
+     * @param resource The memory resource the objects are allocated from.
+     */
+    explicit inline BasicObjectPool(size_t cacheSize = 32, size_t maxShared = 1024, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : _state(std::make_shared<State>(cacheSize < 2 ? 2 : cacheSize, maxShared, resource))
+        , _id(_nextId.fetch_add(1, std::memory_order_relaxed))
+    {
+    }
+
+    BasicObjectPool(const BasicObjectPool&) = delete;
+    BasicObjectPool& operator=(const BasicObjectPool&) = delete;
+
+    /**
+     * @brief Returns an empty SerializedObject, recycled if one is available.
+     */
+    inline BasicSerializedObject<Layout> acquire(void)
+    {
+        Cache& cache = localCache();
+
+        if (cache.objects.empty())
+            _state->refill(cache);
+        if (cache.objects.empty())
+            return BasicSerializedObject<Layout>(_state->resource);
+
+        BasicSerializedObject<Layout> obj(std::move(cache.objects.back()));
+
+        cache.objects.pop_back();
+        return obj;
+    }
+
+    /**
+     * @brief Give obj back to the pool, to be returned by a later acquire() from any thread.
+     * 
+     * obj is cleared and keeps its capacity. Sizing objects are not recycled.
+     * @param obj The object to recycle, left empty.
+     */
+    inline void release(BasicSerializedObject<Layout>&& obj)
+    {
+        if (obj.isSizing())
+            return;
+        Cache& cache = localCache();
+
+        obj.clear();
+        if (cache.objects.size() >= _state->cacheSize)
+            _state->spill(cache);
+        cache.objects.push_back(std::move(obj));
+    }
+
+private:
+    struct Cache {
+        std::vector<BasicSerializedObject<Layout>> objects;
+    };
+
+    struct State {
+        State(size_t cacheSize, size_t maxShared, std::pmr::memory_resource* resource)
+            : cacheSize(cacheSize)
+            , maxShared(maxShared)
+            , resource(resource)
+        {
+        }
+
+        // Moves half of the cache to the shared list
+        inline void spill(Cache& cache)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            move(cache.objects, shared, cacheSize / 2, maxShared);
+        }
+
+        // Takes up to half a cache from the shared list
+        inline void refill(Cache& cache)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            move(shared, cache.objects, cacheSize / 2, cacheSize);
+        }
+
+        inline Cache* attach(void)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            if (!detached.empty()) {
+                Cache* cache = detached.back();
+
+                detached.pop_back();
+                return cache;
+            }
+            caches.push_back(std::make_unique<Cache>());
+            caches.back()->objects.reserve(cacheSize);
+            return caches.back().get();
+        }
+
+        // Called when the thread owning cache exits
+        inline void detach(Cache* cache)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            move(cache->objects, shared, cache->objects.size(), maxShared);
+            cache->objects.clear();
+            detached.push_back(cache);
+        }
+
+        static inline void move(std::vector<BasicSerializedObject<Layout>>& from, std::vector<BasicSerializedObject<Layout>>& to, size_t count, size_t max)
+        {
+            count = std::min(count, from.size());
+            for (size_t i = from.size() - count; i < from.size() && to.size() < max; i++)
+                to.push_back(std::move(from[i]));
+            from.erase(from.end() - count, from.end());
+        }
+
+        const size_t cacheSize;
+        const size_t maxShared;
+        std::pmr::memory_resource* const resource;
+        std::mutex mutex;
+        std::vector<BasicSerializedObject<Layout>> shared;
+        std::vector<std::unique_ptr<Cache>> caches; // One per thread which used the pool
+        std::vector<Cache*> detached; // Caches of exited threads, given to the next threads
+    };
+
+    struct ThreadCaches {
+        struct Entry {
+            size_t id;
+            Cache* cache;
+            std::weak_ptr<State> state;
+        };
+
+        ~ThreadCaches()
+        {
+            for (Entry& entry : entries) {
+                if (std::shared_ptr<State> state = entry.state.lock())
+                    state->detach(entry.cache);
+            }
+        }
+
+        std::vector<Entry> entries;
+    };
 
-namespace bas {
+    inline Cache& localCache(void)
+    {
+        static thread_local ThreadCaches threadCaches;
 
-template <typename T>
-class Helper;
+        for (typename ThreadCaches::Entry& entry : threadCaches.entries) {
+            if (entry.id == _id)
+                return *entry.cache;
+        }
+        threadCaches.entries.erase(std::remove_if(threadCaches.entries.begin(), threadCaches.entries.end(),
+                                       [](const typename ThreadCaches::Entry& entry) { return entry.state.expired(); }),
+            threadCaches.entries.end());
+        threadCaches.entries.push_back({ _id, _state->attach(), _state });
+        return *threadCaches.entries.back().cache;
+    }
 
-template <typename T>
-class PoppedArray;
+    std::shared_ptr<State> _state; // Shared with the caches of the threads, which may exit after the pool is destroyed
+    size_t _id; // Identifies the pool in the caches of the threads, never reused unlike its address
+    static inline std::atomic<size_t> _nextId { 0 };
+};
+
+/// \cond
+struct IndexFormat {
+    static constexpr char MAGIC[8] = { 'B', 'A', 'S', 'I', 'N', 'D', 'X', '1' };
+};
+/// \endcond
 
 /**
- * @brief The SerializedObject contains and manages the payload of your serializations.
+ * @brief The FieldIndex gives access to any field of a payload without popping the fields before it.
  * 
- * This class is the result of a Serializable::serialization. 
+ * The index holds the offset of each field of the payload, found in a single pass reading only
+ * the metadata of the fields, or read from the trailer added by pushTrailer(), in which case nothing
+ * is walked nor allocated. operator[] returns a SerializedView positioned on a field, to pop it
+ * and the fields after it without copying the others.\n
+ * The payload is not modified, payload() and payloadSize() return the original Bytes to forward it as is.
+ * Like the SerializedView, the index does not own the payload, which must outlive it.\n
+ * The trailer is the last field of the payload, so that the payload can still be popped in order by any reader:
+ * @code
+[checksum][field 0]...[field n - 1][sizes][offset 0]...[offset n - 1][n][magic]
+ * @endcode
+ * Offsets and count are stored on Layout::LENGTH_SIZE Bytes.\n
+ * FieldIndex is the BasicFieldIndex using DefaultLayout.
+ * @tparam Layout The layout of the indexed payload.
  */
-class SerializedObject {
+template <typename Layout>
+class BasicFieldIndex {
 public:
-    SerializedObject()
+    using LayoutType = Layout;
+
+    /**
+     * @brief Index the fields of a payload received in a buffer of size Bytes.
+     * @param data The payload.
+     * @param size The number of Bytes available at data.
+     * @throw PayloadError If the checksum does not fit in size or the metadata of a field is out of bounds.
+     */
+    inline BasicFieldIndex(const char* data, size_t size)
     {
-        prepareChecksum();
+        assign(data, size);
     }
 
     /**
-     * @brief Construct object from payload.
-     * 
-     * This operation makes a copy of data.
-     * @param data payload the SerializedObject will be assigned.
+     * @brief Index the fields of the payload of a SerializedView.
      */
-    inline SerializedObject(const char* data)
+    explicit inline BasicFieldIndex(const BasicSerializedView<Layout>& view)
+        : BasicFieldIndex(view.payload(), view.size())
     {
-        constructFromPayload(data);
     }
 
-
     /**
-     * @brief Copy-construct object from another SerializedObject.
-     * @param other The SerializedObject to be copied from.
+     * @brief Index the fields of the payload of a SerializedObject, which must not be modified while it is indexed.
      */
-    inline SerializedObject(const SerializedObject& other)
-        : _data(other._data)
-        , _isChecksumRemoved(other._isChecksumRemoved)
+    explicit inline BasicFieldIndex(const BasicSerializedObject<Layout>& obj)
+        : BasicFieldIndex(obj.payload(), obj.size())
     {
     }
 
     /**
-     * @brief Default destructor.
+     * @brief Index the fields of another payload, reusing the memory of the index.
+     * @see BasicFieldIndex(const char*, size_t)
      */
-    ~SerializedObject() = default;
+    inline void assign(const char* data, size_t size)
+    {
+        _data = data;
+        _size = size < Layout::CHECKSUM_SIZE ? 0 : Layout::readChecksum(data);
+        if (size < Layout::CHECKSUM_SIZE || _size < Layout::CHECKSUM_SIZE || _size > size)
+            throw PayloadError("bas: payload size does not match its checksum");
+        _offsets.clear();
+        if (!readTrailer())
+            walk();
+    }
 
     /**
-     * @brief Pushes data into the payload.
+     * @brief Returns a view positioned on the field at index, which must be lower than size().
      * 
-     * To retreive data pushed by this variant of pushData(), 
-     * use popData<T>() where T is the type of the data pushed.
-     * @param data Data to be pushed.
-     * @see popData<>()
+     * The view ends with the last field, the trailer cannot be popped from it.
+     * @throw PayloadError If the offset of the field read from the trailer is out of bounds.
      */
-    template <typename T>
-    inline void pushData(const T& data)
+    inline BasicSerializedView<Layout> operator[](size_t index) const
     {
-        Helper<T> helper;
-        helper.pushData(*this, data);
+        BasicSerializedView<Layout> view(_data, _end);
+
+        view._readOffset = offset(index);
+        return view;
     }
 
     /**
-     * @brief Pushes an array of data into the object payload.
-     * 
-     * To retreive data pushed by this variant of pushData(),
-     * use popDataArray<T>() where T is the type of the data pushed.
-     * @param data A pointer to the data to be pushed.
-     * @param array_size The size of the array to be pushed.
-     * @see popDataArray<>()
+     * @brief Pop the field at index as a T.
+     * @see BasicSerializedView::popData()
      */
     template <typename T>
-    inline void pushData(const T* data, size_t array_size)
+    inline T get(size_t index) const
     {
-        const char* data_ = (const char*)data;
-        size_t size = sizeof(T);
+        return (*this)[index].template popData<T>();
+    }
 
-        pushSizes(size, array_size);
+    /**
+     * @brief Returns the offset of the field at index in the payload, metadata included.
+     */
+    inline size_t offset(size_t index) const
+    {
+        if (_trailer == nullptr)
+            return _offsets[index];
 
-        pushRawData(size, array_size, data_);
+        size_t offset = Wire::load<Layout::LENGTH_SIZE>(_trailer + index * Layout::LENGTH_SIZE);
 
-        checksumUpdate();
+        if (offset < Layout::CHECKSUM_SIZE || offset >= _end)
+            throw PayloadError("bas: field index out of bounds");
+        return offset;
     }
 
     /**
-     * @brief Pop the next data in the payload.
-     *
-     * @return The popped value from the payload.
+     * @brief Returns the number of fields in the payload, trailer excluded.
      */
-    template <typename T>
-    inline T popData(void)
+    inline size_t size(void) const
     {
-        Helper<T> helper;
-        return helper.popData(*this);
+        return _count;
     }
 
     /**
-     * @brief Pop the next array in the payload and returns a PoppedArray.
+     * @brief Returns true if the offsets were read from a trailer instead of walking the fields.
+     */
+    inline bool hasTrailer(void) const
+    {
+        return _trailer != nullptr;
+    }
+
+    /**
+     * @brief Returns the indexed payload, untouched.
+     */
+    inline const char* payload(void) const
+    {
+        return _data;
+    }
+
+    /**
+     * @brief Returns the size of the indexed payload in Bytes, checksum and trailer included.
+     */
+    inline size_t payloadSize(void) const
+    {
+        return _size;
+    }
+
+    /**
+     * @brief Pushes the trailer of the index of obj as its last field.
      * 
-     * The PoppedArray contains the popped data along with the size of the popped data.
-     * @see PoppedArray
+     * Indexing the payload then reads the offset of a field from the trailer instead of walking the fields before it.
+     * If obj already has a trailer, nothing is done. Nothing should be pushed into obj after its trailer.
+     * @param obj The object whose fields are indexed.
      */
-    template <typename T>
-    inline PoppedArray<T> popDataArray(void)
+    static inline void pushTrailer(BasicSerializedObject<Layout>& obj)
+    {
+        BasicFieldIndex index(obj);
+
+        if (index.hasTrailer())
+            return;
+
+        Buffer trailer(obj.resource());
+        char* cursor = trailer.append((index.size() + 1) * Layout::LENGTH_SIZE + sizeof(IndexFormat::MAGIC));
+
+        for (size_t offset : index._offsets) {
+            Wire::store<Layout::LENGTH_SIZE>(cursor, offset);
+            cursor += Layout::LENGTH_SIZE;
+        }
+        Wire::store<Layout::LENGTH_SIZE>(cursor, index.size());
+        std::memcpy(cursor + Layout::LENGTH_SIZE, IndexFormat::MAGIC, sizeof(IndexFormat::MAGIC));
+        obj.pushData(trailer.data(), trailer.size());
+    }
+
+private:
+    // Returns the offset of the field after the one at offset
+    inline size_t next(size_t offset) const
     {
         size_t size = 0;
         size_t array_size = 0;
-        T* var;
+        size_t length = readBoundedSizes<Layout>(_data + offset, _size - offset, size, array_size);
 
-        std::tie(size, array_size) = getSizes();
+        return offset + length + size * array_size;
+    }
 
-        var = new T[array_size];
+    inline void walk(void)
+    {
+        for (size_t offset = Layout::CHECKSUM_SIZE; offset < _size; offset = next(offset))
+            _offsets.push_back(offset);
+        _trailer = nullptr;
+        _count = _offsets.size();
+        _end = _size;
+    }
 
-        copyMem(size, array_size, var);
+    // Only checks that the trailer is the last field after the last indexed field, other offsets are checked when used
+    inline bool readTrailer(void)
+    {
+        constexpr size_t footer = Layout::LENGTH_SIZE + sizeof(IndexFormat::MAGIC);
 
-        return PoppedArray<T>(array_size, var);
+        if (_size < Layout::CHECKSUM_SIZE + footer || std::memcmp(_data + _size - sizeof(IndexFormat::MAGIC), IndexFormat::MAGIC, sizeof(IndexFormat::MAGIC)) != 0)
+            return false;
+
+        size_t count = Wire::load<Layout::LENGTH_SIZE>(_data + _size - footer);
+
+        if (count > (_size - Layout::CHECKSUM_SIZE - footer) / Layout::LENGTH_SIZE)
+            return false;
+
+        size_t trailer = _size - footer - count * Layout::LENGTH_SIZE;
+        size_t start = Layout::CHECKSUM_SIZE;
+        size_t size = 0;
+        size_t array_size = 0;
+
+        try {
+            if (count != 0) {
+                start = Wire::load<Layout::LENGTH_SIZE>(_data + trailer + (count - 1) * Layout::LENGTH_SIZE);
+                if (start < Layout::CHECKSUM_SIZE || start >= trailer)
+                    return false;
+                start = next(start);
+            }
+            if (start >= trailer || start + readBoundedSizes<Layout>(_data + start, _size - start, size, array_size) != trailer || size * array_size != _size - trailer)
+                return false;
+        } catch (const PayloadError&) {
+            return false; // Not a trailer, the payload merely ends like one
+        }
+        _trailer = _data + trailer;
+        _count = count;
+        _end = start;
+        return true;
     }
 
+    const char* _data = nullptr;
+    size_t _size = 0;
+    size_t _end = 0; // End of the last indexed field, start of the trailer
+    size_t _count = 0;
+    const char* _trailer = nullptr; // Offsets of the trailer
+    std::vector<size_t> _offsets; // Offsets found by walking the payload, when it has no trailer
+};
+
+/**
+ * @brief The Serializable class, when herited from, allows you to
+ * serialize your own classes.
+ * @see makeSerialization()
+ * @see makeUnserialization()
+ */
+class Serializable {
+public:
+
     /**
-     * @brief Returns a pointer to the payload of the object.
+     * @brief Default destructor.
+     */
+    virtual ~Serializable() = default;
+
+    /**
+     * @brief Allow serialization of your class.
      * 
-     * This function is the go-to to get the 'finished product' of your serialization.
-     * @return Pointer to the payload of the SerializedObject 
+     * This function should be overriden, and contain the serialization
+     * process of your class.\n Note that this function is called by serialize() 
+     * should not be called directly bu user end. (see Examples)
+     * @param obj The object to push the data into.
      */
-    inline const char* payload(void) const
-    {
-        return _data.data();
-    }
+    virtual void makeSerialization(SerializedObject& obj) = 0;
+
+    /**
+     * @brief Allow unserialization of your class.
+     * 
+     * This function should be overriden, and contain the unserialization
+     * process of your class.\n Note that this function is called by unserialize() 
+     * should not be called directly bu user end. (see Examples)
+     * @param obj The object to pop the data from.
+     */
+    virtual void makeUnserialization(SerializedObject& obj) = 0;
 
     /**
-     * @brief Returns a reference to the std::vector containing the payload.
+     * @brief Reconstruct object from a SerializedObject
      * 
-     * User-end should use this function only in rare case, manually modifying 
-     * the payload may end up in undefined behaviours.
+     * This function rewinds the SerializedObject before unserializing, without copying it,
+     * meaning that the same object can be used to unserialize multiple times.\n
+     * The unserializing process of this function is defined by overriding makeUnserialization.
+     * @param obj SerializedObject to unserialize from.
+     * @see SerializedObject::rewind()
      */
-    inline std::vector<char>& vector(void)
+    inline void unserialize(SerializedObject& obj)
     {
-        return _data;
+        obj.rewind();
+        makeUnserialization(obj);
     }
 
     /**
-     * @brief Returns the size of the payload in Bytes.
+     * @brief Reconstruct object from a const SerializedObject
      * 
-     * This size include all the metadata that is added by the SerializedObject to the payload.
-     * @return The size of the payload.
+     * Since popping moves the read cursor of the SerializedObject,
+     * this variant has to unserialize from a copy of obj.
+     * @param obj SerializedObject to unserialize from.
      */
-    inline size_t size(void) const
+    inline void unserialize(const SerializedObject& obj)
     {
-        return _data.size();
+        SerializedObject copy(obj);
+
+        unserialize(copy);
     }
 
     /**
-     * @brief Clear the SerializedObject and resets it to its default values.
+     * @brief Reconstruct object from a temporary SerializedObject
+     * 
+     * The temporary is unserialized in place, without being copied.
+     * @param obj SerializedObject to unserialize from.
      */
-    inline void clear()
+    inline void unserialize(SerializedObject&& obj)
     {
-        _data.clear();
-        _isChecksumRemoved = false;
+        unserialize(obj);
     }
 
     /**
-     * @brief Assign values to the SerializedObject.
-     * @param other SerializedObject to be copied from
+     * @brief Serialize the class.
+     * 
+     * This function create a SerializedObject of your class.\n
+     * The serializing process of this function is defined by overriding makeSerialization.
+     * The payload grows as data is pushed into it, see serialize(Sizing, std::pmr::memory_resource*)
+     * to allocate it once.\n
+     * While serializedSize() runs on the calling thread, this returns an empty sizing SerializedObject instead,
+     * so that the objects a makeSerialization nests with serialize() are only sized:
+     * makeSerialization must push them, not pop from them or read their payload.
+     * @param resource The memory resource the payload is allocated from.
+     * @return The SerializedObject containing the data of the class.
+     * @see serializedSize()
      */
-    inline SerializedObject& operator=(const SerializedObject& other)
+    inline SerializedObject serialize(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
     {
-        _data = other._data;
-        _isChecksumRemoved = other._isChecksumRemoved;
-        return *this;
+        if (_sizingDepth > 0) {
+            SerializedObject obj(sizing);
+            makeSerialization(obj);
+            return obj;
+        }
+        SerializedObject obj(resource);
+        makeSerialization(obj);
+        return obj;
     }
 
     /**
-     * @brief Assign a copy of data to the payload.
+     * @brief Serialize the class into a payload allocated once, at its exact size.
      * 
-     * This function erase the current payload.\n
-     * If data is not a payload extracted with SerializedObject::payload(),
-     * behaviour might be undefined.
-     * @param data payload the SerializedObject will be assigned.
+     * The size is computed by serializedSize(), which runs makeSerialization a first time.
+     * This is worth it for large payloads, which would otherwise be reallocated and copied as they grow.
+     * @code
+bas::SerializedObject obj = person.serialize(bas::sizing);
+     * @endcode
+     * @param resource The memory resource the payload is allocated from.
+     * @return The SerializedObject containing the data of the class.
      */
-    inline SerializedObject& operator=(const char* data)
+    inline SerializedObject serialize(Sizing, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
     {
-        constructFromPayload(data);
-        return *this;
+        if (_sizingDepth > 0)
+            return serialize(resource);
+        SerializedObject obj(resource);
+        obj.reserve(serializedSize());
+        makeSerialization(obj);
+        return obj;
     }
 
     /**
-     * @brief Remove Checksum at the beggining of payload.
+     * @brief Serialize the class into obj.
      * 
-     * If checksum has already been removed, nothing is done.\n
-     * This function should not be used by user end, except for extremely rare case.
+     * obj is cleared first and keeps its capacity, so that serializing into an object
+     * acquired from an ObjectPool reuses its buffer instead of allocating one.
+     * @param obj The SerializedObject the data of the class is pushed into.
+     * @see BasicObjectPool
      */
-    inline void removeChecksum(void)
+    inline void serialize(SerializedObject& obj)
     {
-        if (_isChecksumRemoved)
-            return;
-        _isChecksumRemoved = true;
-        for (size_t i = 0; i < _BAS_CHECKSUM_SIZE_; i++)
-            _data.erase(_data.begin());
+        obj.clear();
+        makeSerialization(obj);
     }
 
     /**
-     * @brief Add Checksum at the beggining of payload.
+     * @brief Computes the exact size of the payload serialize() would return, without serializing.
      * 
-     * If checksum has already been added, nothing is done.\n
-     * This function should not be used by user end, except for extremely rare case.
+     * The size is computed by running makeSerialization on a sizing SerializedObject,
+     * SerializedObjects nested with serialize() during that run are only sized as well:
+     * until it returns, serialize() called on the same thread, on any Serializable, returns a sizing SerializedObject.\n
+     * serialize(Sizing, std::pmr::memory_resource*) uses this size to allocate the payload once.
+     * @return The size of the serialized payload in Bytes.
+     * @see BasicSerializedObject::BasicSerializedObject(Sizing)
      */
-    inline void addChecksum(void)
+    inline size_t serializedSize(void)
     {
-        if (!_isChecksumRemoved)
-            return;
-        for (size_t i = 0; i < _BAS_CHECKSUM_SIZE_; i++)
-            _data.insert(_data.begin(), 0);
-        checksumUpdate();
+        SerializedObject obj(sizing);
+        SizingScope scope;
+
+        makeSerialization(obj);
+        return obj.size();
     }
 
 private:
-    inline void prepareChecksum(void)
+    struct SizingScope {
+        SizingScope()
+        {
+            _sizingDepth++;
+        }
+
+        ~SizingScope()
+        {
+            _sizingDepth--;
+        }
+    };
+
+    static inline thread_local size_t _sizingDepth = 0; // Number of serializedSize() being run on this thread
+};
+
+/**
+ * @brief Declares the fields of a Reflectable class, in serialization order.
+ * 
+ * Must be used in the public section of a class inheriting from Reflectable.
+ * @see Reflectable
+ */
+#define BAS_FIELDS(...)                         \
+    inline auto basFields(void)                 \
+    {                                           \
+        return std::tie(__VA_ARGS__);           \
+    }                                           \
+    inline auto basFields(void) const           \
+    {                                           \
+        return std::tie(__VA_ARGS__);           \
+    }
+
+/**
+ * @brief The Reflectable class, when herited from, serializes your class from a list of its fields.
+ * 
+ * Unlike Serializable, the serialization process is generated by the compiler from the
+ * fields declared with BAS_FIELDS(), in the same order for pushing and popping,
+ * and without any virtual call.\n
+ * The size of the fields of fixed size (trivially copyable types pushed as their raw Bytes, unlike std::string_view
+ * or SerializedView) is known at compile time,
+ * they are written all at once in a single extension of the payload.
+ * A field can be of any type handled by pushData, or another Reflectable class.
+ * @code
+class Point : public bas::Reflectable<Point> {
+public:
+    BAS_FIELDS(x, y, name)
+
+    int x;
+    int y;
+    std::string name;
+};
+ * @endcode
+ */
+template <typename Derived>
+class Reflectable {
+public:
+    /**
+     * @brief Returns the size in Bytes of the fields of fixed size, metadata included.
+     * @tparam Layout The layout of the payload.
+     */
+    template <typename Layout = DefaultLayout>
+    static constexpr size_t fixedSize(void)
     {
-        for (size_t i = 0; i < _BAS_CHECKSUM_SIZE_; i++)
-            _data.push_back(0);
+        return Fields<decltype(std::declval<const Derived&>().basFields()), Layout>::fixedSize;
     }
 
-    inline void constructFromPayload(const char* data)
+    /**
+     * @brief Returns true if every field of the class is of fixed size.
+     * 
+     * In that case, the size of the serialized payload is always Layout::CHECKSUM_SIZE + fixedSize().
+     */
+    static constexpr bool isFixedSize(void)
     {
-        size_t size = 0;
-        for (size_t i = 0; i < _BAS_CHECKSUM_SIZE_; i++) {
-            size |= (data[i] << (i * 8));
-        }
-        std::cout << size << std::endl;
-        _data.assign(data, data + size);
+        return Fields<decltype(std::declval<const Derived&>().basFields()), DefaultLayout>::isFixedSize;
+    }
+
+    /**
+     * @brief Serialize the class.
+     * @tparam Layout The layout of the payload.
+     * @param resource The memory resource the payload is allocated from.
+     * @return The SerializedObject containing the fields of the class.
+     */
+    template <typename Layout = DefaultLayout>
+    inline BasicSerializedObject<Layout> serialize(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const
+    {
+        BasicSerializedObject<Layout> obj(resource);
+
+        obj.reserve(serializedSize<Layout>());
+        makeSerialization(obj);
+        return obj;
+    }
+
+    /**
+     * @brief Serialize the class into obj.
+     * 
+     * obj is cleared first and keeps its capacity.
+     * @param obj The SerializedObject the fields of the class are pushed into.
+     * @see BasicObjectPool
+     */
+    template <typename Layout>
+    inline void serialize(BasicSerializedObject<Layout>& obj) const
+    {
+        obj.clear();
+        makeSerialization(obj);
     }
 
-    inline void checksumUpdate(void)
+    /**
+     * @brief Computes the exact size of the payload serialize() would return, without serializing.
+     * 
+     * Only the fields that are not of fixed size are looked at.
+     * @tparam Layout The layout of the payload.
+     * @return The size of the serialized payload in Bytes.
+     */
+    template <typename Layout = DefaultLayout>
+    inline size_t serializedSize(void) const
     {
-        size_t size = _data.size();
-
-        if (_isChecksumRemoved)
-            addChecksum();
+        auto fields = static_cast<const Derived&>(*this).basFields();
+        size_t size = Layout::CHECKSUM_SIZE + fixedSize<Layout>();
 
-        for (size_t i = 0; i < _BAS_CHECKSUM_SIZE_; i++) {
-            _data[i] = (size >> (i * 8));
-        }
+        if constexpr (!isFixedSize())
+            std::apply([&](const auto&... field) { ((size += fieldSize<Layout>(field)), ...); }, fields);
+        return size;
     }
 
-    inline void pushRawData(size_t size, size_t array_size, const char* data)
+    /**
+     * @brief Reconstruct object from a SerializedObject, without copying it.
+     * @param obj SerializedObject to unserialize from.
+     */
+    template <typename Layout>
+    inline void unserialize(const BasicSerializedObject<Layout>& obj)
     {
-        for (size_t j = 0; j < array_size; j++) {
-            for (size_t i = 0; i < size; i++) {
-                _data.push_back(data[j * size + i]);
-            }
-        }
+        BasicSerializedView<Layout> view(obj);
+
+        makeUnserialization(view);
     }
 
-    inline void pushSizes(size_t size, size_t array_size)
+    /**
+     * @brief Reconstruct object from a SerializedView.
+     * @param view SerializedView to unserialize from.
+     */
+    template <typename Layout>
+    inline void unserialize(BasicSerializedView<Layout> view)
     {
-        for (size_t i = 0; i < _BAS_SIZE_BYTES_; i++)
-            _data.push_back((size >> (i * 8)) & 0xFF);
-
-        for (size_t i = 0; i < _BAS_ARRAY_SIZE_; i++)
-            _data.push_back((array_size >> (i * 8)) & 0xFF);
+        view.rewind();
+        makeUnserialization(view);
     }
 
-    inline std::tuple<int, int> getSizes(void)
+    /**
+     * @brief Push the fields of the class into obj.
+     * 
+     * Called by serialize(), can be called directly to push the fields into an existing SerializedObject.
+     * @param obj The object to push the data into.
+     */
+    template <typename Layout>
+    inline void makeSerialization(BasicSerializedObject<Layout>& obj) const
     {
-        size_t size = 0, array_size = 0;
-
-        if (!_isChecksumRemoved) {
-            removeChecksum();
-        }
+        auto fields = static_cast<const Derived&>(*this).basFields();
 
-        for (size_t i = 0; i < _BAS_SIZE_BYTES_; i++) {
-            size |= (_data.front() << (i * 8));
-            _data.erase(_data.begin());
+        if (obj._isSizing) {
+            obj._sizedBytes += serializedSize<Layout>() - Layout::CHECKSUM_SIZE;
+            return;
         }
+        if constexpr (isFixedSize()) {
+            char* data = obj.extend(fixedSize<Layout>());
 
-        for (size_t i = 0; i < _BAS_ARRAY_SIZE_; i++) {
-            array_size |= (_data.front() << (i * 8));
-            _data.erase(_data.begin());
+            std::apply([&](const auto&... field) { (writeField<Layout>(data, field), ...); }, fields);
+        } else {
+            std::apply([&](const auto&... field) { (pushField(obj, field), ...); }, fields);
         }
-        return std::make_tuple(size, array_size);
     }
 
-    template <typename T>
-    inline void copyMem(size_t size, size_t array_size, T* var)
+    /**
+     * @brief Pop the fields of the class from obj.
+     * 
+     * Called by unserialize(), can be called directly to pop the fields from the current
+     * position of a SerializedObject or SerializedView.
+     * @param obj The object to pop the data from.
+     */
+    template <typename Obj>
+    inline void makeUnserialization(Obj& obj)
     {
-        for (size_t j = 0; j < array_size; j++) {
-            std::memcpy(var + j, _data.data(), size);
-            for (size_t i = 0; i < size; i++) {
-                _data.erase(_data.begin());
-            }
-        }
+        auto fields = static_cast<Derived&>(*this).basFields();
+
+        std::apply([&](auto&... field) { (popField(obj, field), ...); }, fields);
     }
 
-    std::vector<char> _data;
-    bool _isChecksumRemoved = false;
+private:
+/// \cond
+    template <typename T>
+    static constexpr bool isReflectable = std::is_base_of_v<Reflectable<T>, T>;
+
+    template <typename T, typename = void>
+    struct HasGenericHelper : std::false_type {
+    };
 
     template <typename T>
-    friend class Helper;
-    friend class Helper<std::string>;
-};
+    struct HasGenericHelper<T, std::void_t<decltype(Helper<T>::IS_GENERIC)>> : std::true_type {
+    };
 
-/**
- * @brief The Serializable class, when herited from, allows you to
- * serialize your own classes.
- * @see makeSerialization()
- * @see makeUnserialization()
- */
-class Serializable {
-public:
+    // Types with their own Helper, like std::string_view or SerializedView, point to their data and are not fixed
+    template <typename T>
+    static constexpr bool isFixedField = std::is_trivially_copyable_v<T> && !std::is_pointer_v<T> && !isReflectable<T> && HasGenericHelper<T>::value;
 
-    /**
-     * @brief Default destructor.
-     */
-    virtual ~Serializable() = default;
+    template <typename Tuple, typename Layout>
+    struct Fields;
 
-    /**
-     * @brief Allow serialization of your class.
-     * 
-     * This function should be overriden, and contain the serialization
-     * process of your class.\n Note that this function is called by serialize() 
-     * should not be called directly bu user end. (see Examples)
-     * @param obj The object to push the data into.
-     */
-    virtual void makeSerialization(SerializedObject& obj) = 0;
+    template <typename... T, typename Layout>
+    struct Fields<std::tuple<T...>, Layout> {
+        static constexpr bool isFixedSize = (isFixedField<std::decay_t<T>> && ...);
+        static constexpr size_t fixedSize = ((isFixedField<std::decay_t<T>> ? Layout::sizesLength(sizeof(std::decay_t<T>), 1) + sizeof(std::decay_t<T>) : 0) + ... + 0);
+    };
+/// \endcond
 
-    /**
-     * @brief Allow unserialization of your class.
-     * 
-     * This function should be overriden, and contain the unserialization
-     * process of your class.\n Note that this function is called by unserialize() 
-     * should not be called directly bu user end. (see Examples)
-     * @param obj The object to pop the data from.
-     */
-    virtual void makeUnserialization(SerializedObject& obj) = 0;
+    template <typename Layout, typename T>
+    static inline void writeField(char*& data, const T& field)
+    {
+        data += Layout::writeSizes(data, sizeof(T), 1);
+        if constexpr (Layout::SWAP_BYTES && Wire::isSwappable<T>)
+            Wire::swapBytes<sizeof(T)>(data, (const char*)&field, 1);
+        else
+            std::memcpy(data, &field, sizeof(T));
+        data += sizeof(T);
+    }
 
-    /**
-     * @brief Reconstruct object from a SerializedObject
-     * 
-     * This function copies the SerializedObject before unserializing,
-     * meaning that the same object can be used to unserialize multiple times.\n
-     * The unserializing process of this function is defined by overriding makeUnserialization.
-     * @param obj SerializedObject to unserialize from.
-     */
-    inline void unserialize(SerializedObject obj)
+    template <typename Layout, typename T>
+    static inline size_t fieldSize(const T& field)
     {
-        makeUnserialization(obj);
+        if constexpr (isFixedField<T>) {
+            return 0; // Already counted in fixedSize()
+        } else if constexpr (isReflectable<T>) {
+            return Layout::NESTED_SIZES_LENGTH + field.template serializedSize<Layout>();
+        } else {
+            Helper<T> helper;
+            return helper.template serializedSize<Layout>(field);
+        }
     }
 
-    /**
-     * @brief Serialize the class.
-     * 
-     * This function create a SerializedObject of your class.\n
-     * The serializing process of this function is defined by overriding makeSerialization.
-     * @return The SerializedObject containing the data of the class.
-     */
-    inline SerializedObject serialize(void)
+    template <typename Layout, typename T>
+    static inline void pushField(BasicSerializedObject<Layout>& obj, const T& field)
     {
-        SerializedObject obj;
-        makeSerialization(obj);
-        return obj;
+        if constexpr (isReflectable<T>)
+            obj.pushObject(field);
+        else
+            obj.pushData(field);
     }
 
-private:
+    template <typename Obj, typename T>
+    static inline void popField(Obj& obj, T& field)
+    {
+        if constexpr (isReflectable<T>)
+            obj.popObject(field);
+        else
+            field = obj.template popData<T>();
+    }
 };
 
 /**
@@ -419,7 +4763,7 @@ public:
 
     inline PoppedArray(size_t size, T* ptr)
         : _size(size)
-        , _ptr(ptr)
+        , _ptr(ptr, std::default_delete<T[]>())
     {
     }
 /// \endcond
@@ -452,29 +4796,114 @@ private:
     std::shared_ptr<T> _ptr;
 };
 
+/**
+ * @brief The PoppedSpan is the return value of SerializedObject::popDataSpan<>().
+ * 
+ * The PoppedSpan either points directly into the payload it has been popped from,
+ * or holds a copy of the popped data if it was not suitably aligned in the payload.\n
+ * In the first case, it is invalidated along with the payload.
+ */
+template <typename T>
+class PoppedSpan {
+
+public:
+/// \cond
+    PoppedSpan() = default;
+
+    inline PoppedSpan(size_t size, const T* ptr)
+        : _size(size)
+        , _ptr(ptr)
+    {
+    }
+
+    inline PoppedSpan(size_t size, T* copy)
+        : _size(size)
+        , _ptr(copy)
+        , _copy(copy, std::default_delete<T[]>())
+    {
+    }
+/// \endcond
+
+    /**
+     * @brief Returns the number of elements of the popped array.
+     */
+    inline size_t size(void) const
+    {
+        return _size;
+    }
+
+    /**
+     * @brief Returns the pointer to the popped array.
+     */
+    inline const T* get(void) const
+    {
+        return _ptr;
+    }
+
+    /**
+     * @brief Returns true if the PoppedSpan holds a copy of the data instead of pointing into the payload.
+     */
+    inline bool isCopy(void) const
+    {
+        return _copy != nullptr;
+    }
+
+    inline const T& operator[](size_t i) const
+    {
+        return _ptr[i];
+    }
+
+    inline const T* begin(void) const
+    {
+        return _ptr;
+    }
+
+    inline const T* end(void) const
+    {
+        return _ptr + _size;
+    }
+
+private:
+    size_t _size = 0;
+    const T* _ptr = nullptr;
+    std::shared_ptr<T> _copy;
+};
+
 
 /**
  * @brief Helper class are used by the SerializedObject to allow partial
  * specialization of SerializedObject::pushData<T>() and SerializedObject::popData<T>(), and should not be used by
- * user end.
+ * user end.\n
+ * popData() is shared by SerializedObject and SerializedView.
  */
 template <typename T>
 class Helper {
 public:
-    inline void pushData(SerializedObject& obj, const T& data_)
+/// \cond
+    static constexpr bool IS_GENERIC = true; // T is pushed as its raw Bytes, the specializations are not
+/// \endcond
+
+    template <typename Layout>
+    inline size_t serializedSize(const T&)
+    {
+        return Layout::sizesLength(sizeof(T), 1) + sizeof(T);
+    }
+
+    template <typename Layout>
+    inline void pushData(BasicSerializedObject<Layout>& obj, const T& data_)
     {
-        const char* data = (const char*)&data_;
         size_t size = sizeof(T);
         size_t array_size = 1;
 
         obj.pushSizes(size, array_size);
 
-        obj.pushRawData(size, array_size, data);
+        obj.pushRawArray(&data_, array_size);
 
         obj.checksumUpdate();
     }
 
-    inline T popData(SerializedObject& obj)
+    template <typename Obj>
+    inline T popData(Obj& obj)
     {
         size_t size = 0;
         size_t array_size = 0;
@@ -482,6 +4911,10 @@ public:
 
         std::tie(size, array_size) = obj.getSizes();
 
+        if (array_size != 1 || size != sizeof(T)) {
+            obj.readData(size * array_size); // Skips the field, so that the next pop reads the one after it
+            throw PayloadError(array_size != 1 ? "bas: popped an array as a single value" : "bas: popped a value of another size");
+        }
         obj.copyMem(size, array_size, &var);
 
         return var;
@@ -492,7 +4925,14 @@ public:
 template <>
 class Helper<std::string> {
 public:
-    inline void pushData(SerializedObject& obj, const std::string& data_)
+    template <typename Layout>
+    inline size_t serializedSize(const std::string& data_)
+    {
+        return Layout::sizesLength(sizeof(char), data_.size() + 1) + data_.size() + 1;
+    }
+
+    template <typename Layout>
+    inline void pushData(BasicSerializedObject<Layout>& obj, const std::string& data_)
     {
         const char* data = data_.c_str();
         size_t size = sizeof(char);
@@ -505,24 +4945,62 @@ public:
         obj.checksumUpdate();
     }
 
-    inline std::string popData(SerializedObject &obj)
+    template <typename Obj>
+    inline std::string popData(Obj &obj)
     {
         size_t size = 0;
         size_t array_size = 0;
-        std::string str;
-        char* var;
+        const char* data;
 
         std::tie(size, array_size) = obj.getSizes();
-    
-        var = new char[array_size];
-    
-        obj.copyMem(size, array_size, var);
-    
-        str = var;
-    
-        delete[] var;
-    
-        return str;
+
+        data = obj.readData(size * array_size);
+        if (size != sizeof(char))
+            throw PayloadError("bas: popped an array of another type as a string");
+
+        return std::string(data, array_size ? array_size - 1 : 0);
+    }
+
+};
+
+template <>
+class Helper<std::string_view> {
+public:
+    template <typename Layout>
+    inline size_t serializedSize(const std::string_view& data_)
+    {
+        return Layout::sizesLength(sizeof(char), data_.size() + 1) + data_.size() + 1;
+    }
+
+    template <typename Layout>
+    inline void pushData(BasicSerializedObject<Layout>& obj, const std::string_view& data_)
+    {
+        size_t size = sizeof(char);
+        size_t array_size = data_.size() + 1;
+        const char terminator = '\0';
+
+        obj.pushSizes(size, array_size);
+
+        obj.pushRawData(size, data_.size(), data_.data());
+        obj.pushRawData(size, 1, &terminator);
+
+        obj.checksumUpdate();
+    }
+
+    template <typename Obj>
+    inline std::string_view popData(Obj &obj)
+    {
+        size_t size = 0;
+        size_t array_size = 0;
+        const char* data;
+
+        std::tie(size, array_size) = obj.getSizes();
+
+        data = obj.readData(size * array_size);
+        if (size != sizeof(char))
+            throw PayloadError("bas: popped an array of another type as a string");
+
+        return std::string_view(data, array_size ? array_size - 1 : 0);
     }
 
 };
@@ -530,45 +5008,115 @@ public:
 template <typename T>
 class Helper<std::vector<T>> {
 public:
-    inline void pushData(SerializedObject& obj, const std::vector<T>& data_)
+    template <typename Layout>
+    inline size_t serializedSize(const std::vector<T>& data_)
+    {
+        return Layout::sizesLength(sizeof(T), data_.size()) + sizeof(T) * data_.size();
+    }
+
+    template <typename Layout>
+    inline void pushData(BasicSerializedObject<Layout>& obj, const std::vector<T>& data_)
     {
-        const char* data = (char*)data_.data();
         size_t size = sizeof(T);
         size_t array_size = data_.size();
         
         obj.pushSizes(size, array_size);
 
-        obj.pushRawData(size, array_size, data);
+        obj.pushRawArray(data_.data(), array_size);
 
         obj.checksumUpdate();
     }
 
-    inline std::vector<T> popData(SerializedObject &obj)
+    template <typename Obj>
+    inline std::vector<T> popData(Obj &obj)
     {
         size_t size = 0;
         size_t array_size = 0;
         std::vector<T> vector;
+
+        std::tie(size, array_size) = obj.getSizes();
+
+        vector.resize(array_size);
+
+        obj.copyMem(size, array_size, vector.data());
+
+        return vector;
+    }
+
+};
+
+template <typename T>
+class Helper<PoppedSpan<T>> {
+public:
+    template <typename Obj>
+    inline PoppedSpan<T> popData(Obj &obj)
+    {
+        size_t size = 0;
+        size_t array_size = 0;
         T* var;
 
         std::tie(size, array_size) = obj.getSizes();
-    
+
+        constexpr bool swapped = Obj::LayoutType::SWAP_BYTES && Wire::isSwappable<T>;
+
+        if (!swapped && size == sizeof(T) && reinterpret_cast<std::uintptr_t>(obj.readPointer()) % alignof(T) == 0)
+            return PoppedSpan<T>(array_size, (const T*)obj.readData(size * array_size));
+
         var = new T[array_size];
-    
+
         obj.copyMem(size, array_size, var);
-    
-        vector.assign(var, var + array_size);
-    
-        delete[] var;
-    
-        return vector;
+
+        return PoppedSpan<T>(array_size, var);
     }
 
 };
 
-template <>
-class Helper<SerializedObject> {
+template <typename ViewLayout>
+class Helper<BasicSerializedView<ViewLayout>> {
+public:
+    template <typename Layout>
+    inline size_t serializedSize(const BasicSerializedView<ViewLayout>& data_)
+    {
+        return Layout::sizesLength(sizeof(char), data_.size()) + data_.size();
+    }
+
+    template <typename Layout>
+    inline void pushData(BasicSerializedObject<Layout>& obj, const BasicSerializedView<ViewLayout>& data_)
+    {
+        size_t size = sizeof(char);
+        size_t array_size = data_.size();
+
+        obj.pushSizes(size, array_size);
+
+        obj.pushRawData(size, array_size, data_.payload());
+
+        obj.checksumUpdate();
+    }
+
+    template <typename Obj>
+    inline BasicSerializedView<ViewLayout> popData(Obj &obj)
+    {
+        size_t size = 0;
+        size_t array_size = 0;
+
+        std::tie(size, array_size) = obj.getSizes();
+
+        return BasicSerializedView<ViewLayout>(obj.readData(size * array_size), size * array_size);
+    }
+
+};
+
+template <typename ObjLayout>
+class Helper<BasicSerializedObject<ObjLayout>> {
 public:
-    inline void pushData(SerializedObject& obj, const SerializedObject& data_)
+    template <typename Layout>
+    inline size_t serializedSize(const BasicSerializedObject<ObjLayout>& data_)
+    {
+        return Layout::sizesLength(sizeof(char), data_.size()) + data_.size();
+    }
+
+    template <typename Layout>
+    inline void pushData(BasicSerializedObject<Layout>& obj, const BasicSerializedObject<ObjLayout>& data_)
     {
         const char* data = (char*)data_.payload();
         size_t size = sizeof(char);
@@ -581,26 +5129,39 @@ public:
         obj.checksumUpdate();
     }
 
-    inline SerializedObject popData(SerializedObject &obj)
+    template <typename Obj>
+    inline BasicSerializedObject<ObjLayout> popData(Obj &obj)
     {
         size_t size = 0;
         size_t array_size = 0;
-        SerializedObject _obj;
-        char* var;
+        BasicSerializedObject<ObjLayout> _obj(resourceOf(obj));
+        const char* data;
 
         std::tie(size, array_size) = obj.getSizes();
-    
-        var = new char[array_size];
-    
-        obj.copyMem(size, array_size, var);
-    
-        _obj = var;
-    
-        delete[] var;
-    
+
+        data = obj.readData(size * array_size);
+        if (size * array_size < ObjLayout::CHECKSUM_SIZE || ObjLayout::readChecksum(data) != size * array_size)
+            throw PayloadError("bas: nested object does not match its size");
+
+        _obj._data.assign(data, data + size * array_size);
+        _obj._isChecksumOutdated = false;
+
         return _obj;
     }
 
+private:
+    template <typename Layout>
+    static inline std::pmr::memory_resource* resourceOf(const BasicSerializedObject<Layout>& obj)
+    {
+        return obj.resource();
+    }
+
+    template <typename Obj>
+    static inline std::pmr::memory_resource* resourceOf(const Obj&)
+    {
+        return std::pmr::get_default_resource();
+    }
+
 };
 /// \endcond
 }
@@ -632,6 +5193,12 @@ public:
  * @example intrication.cpp
  */
 
+/**
+ * @brief The Reflectable class does the same as our first example, without writing
+ * the serialization process by hand.
+ * @example reflection.cpp
+ */
+
 /**
  * @mainpage
  * Simple example to start with:
@@ -0,0 +1,130 @@
+/*
+** ByteArraySerialisation
+** File description:
+** ArchiveWriter batches at the limit of the length of the layout, read back by the ArchiveReader.
+*/
+
+#include "bas.hpp"
+#include "check.hpp"
+#include "layouts.hpp"
+
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+
+// Offsets and count on 2 Bytes, a batch holds at most 65535 Bytes
+using Short = bas::FixedLayout<2, 2, 2>;
+using ShortWriter = bas::BasicArchiveWriter<Short>;
+
+static_assert(ShortWriter::MAX_BATCH_SIZE == 65535 - 2 * Short::LENGTH_SIZE);
+static_assert(bas::BasicArchiveWriter<Fixed>::MAX_BATCH_SIZE == 4294967295 - 2 * Fixed::LENGTH_SIZE);
+
+static const std::string path = "bas_test_archive.archive";
+
+// The biggest record a batch of the Short layout can hold
+static const size_t MAX_RECORD_SIZE = ShortWriter::MAX_BATCH_SIZE - Short::CHECKSUM_SIZE;
+
+struct Blob : bas::Reflectable<Blob> {
+    BAS_FIELDS(text)
+    std::string text;
+};
+
+// A Blob whose payload is size Bytes, checksum and null terminator of the text included
+static Blob blob(size_t size, char c)
+{
+    Blob blob;
+
+    blob.text.assign(size - Short::CHECKSUM_SIZE - Short::sizesLength(1, size) - 1, c);
+    return blob;
+}
+
+#ifdef _BAS_HAS_MMAP_
+static void checkRecords(const std::string& expected)
+{
+    bas::BasicArchiveReader<Short> reader(path);
+
+    CHECK(reader.size() == expected.size());
+    for (size_t i = 0; i < reader.size() && i < expected.size(); i++) {
+        bas::BasicSerializedView<Short> record = reader[i];
+        std::string text = record.popData<std::string>();
+
+        CHECK(!text.empty() && text == std::string(text.size(), expected[i]));
+    }
+}
+#endif
+
+TEST(recordsAtLengthLimitReadBack)
+{
+    {
+        ShortWriter writer(path, ShortWriter::MAX_BATCH_SIZE);
+        Blob first = blob(40000, 'a');
+        Blob second = blob(40000, 'b');
+
+        // The second record overflows the first batch once serialized, it moves to the next batch
+        writer.push(first);
+        writer.push(second);
+        writer.pushPayload(blob(40000, 'c').serialize<Short>());
+        writer.pushPayload(blob(MAX_RECORD_SIZE, 'd').serialize<Short>());
+        writer.push(first);
+    }
+#ifdef _BAS_HAS_MMAP_
+    checkRecords("abcda");
+    CHECK(bas::BasicArchiveReader<Short>(path).batchCount() == 5);
+#endif
+    CHECK(std::remove(path.c_str()) == 0);
+}
+
+TEST(recordBiggerThanBatchThrows)
+{
+    {
+        ShortWriter writer(path, ShortWriter::MAX_BATCH_SIZE);
+        Blob small = blob(100, 'a');
+        Blob big = blob(MAX_RECORD_SIZE + 1, 'b');
+
+        writer.push(small);
+        CHECK_THROWS(std::invalid_argument, writer.push(big));
+        CHECK_THROWS(std::invalid_argument, writer.pushPayload(big.serialize<Short>()));
+        writer.push(small);
+    }
+#ifdef _BAS_HAS_MMAP_
+    checkRecords("aa");
+    CHECK(bas::BasicArchiveReader<Short>(path).batchCount() == 1);
+#endif
+    CHECK(std::remove(path.c_str()) == 0);
+}
+
+#ifdef _BAS_HAS_MMAP_
+TEST(archiveCrcMismatchThrows)
+{
+    {
+        bas::BasicArchiveWriter<Crc> writer(path, 64);
+        Blob record = blob(40, 'a');
+
+        for (size_t i = 0; i < 4; i++)
+            writer.push(record);
+    }
+    CHECK(bas::BasicArchiveReader<Crc>(path).size() == 4);
+
+    std::FILE* file = std::fopen(path.c_str(), "r+b");
+
+    // Flip a Byte in the text of the last record
+    std::fseek(file, -int(2 * Crc::LENGTH_SIZE + 10), SEEK_END);
+    std::fputc('b', file);
+    std::fclose(file);
+    CHECK_THROWS(bas::PayloadError, bas::BasicArchiveReader<Crc> { path });
+    CHECK(std::remove(path.c_str()) == 0);
+}
+#endif
+
+TEST(batchSizeBiggerThanLengthThrows)
+{
+    std::remove(path.c_str());
+    CHECK_THROWS(std::invalid_argument, ShortWriter(path, ShortWriter::MAX_BATCH_SIZE + 1));
+    CHECK_THROWS(std::invalid_argument, bas::BasicArchiveWriter<Fixed>(path, size_t(1) << 32));
+    CHECK(std::remove(path.c_str()) != 0); // Not created when the batch size is rejected
+}
+
+int main(void)
+{
+    return runTests();
+}
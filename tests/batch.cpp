@@ -0,0 +1,128 @@
+/*
+** ByteArraySerialisation
+** File description:
+** BatchReader on valid batches and on malformed offset tables.
+*/
+
+#include "bas.hpp"
+#include "check.hpp"
+#include "layouts.hpp"
+
+#include <string>
+
+template <typename Layout>
+static std::string sampleBatch(size_t count)
+{
+    bas::BasicBatchWriter<Layout> writer;
+
+    for (size_t i = 0; i < count; i++) {
+        bas::BasicSerializedObject<Layout> record;
+
+        record.pushData(int(i));
+        record.pushData(std::string(i, 'x'));
+        writer.pushPayload(record);
+    }
+    bas::BasicSerializedObject<Layout> batch = writer.finish();
+
+    return std::string(batch.payload(), batch.size());
+}
+
+// Offset of entry index of the table of a batch of count records
+template <typename Layout>
+static size_t tableEntry(const std::string& batch, size_t count, size_t index)
+{
+    return batch.size() - (count + 1 - index) * Layout::LENGTH_SIZE;
+}
+
+template <typename Layout>
+static void readRecords(void)
+{
+    for (size_t count : { 0, 1, 5, 300 }) {
+        std::string batch = sampleBatch<Layout>(count);
+        bas::BasicBatchReader<Layout> reader(batch.data(), batch.size());
+
+        CHECK(reader.size() == count);
+        for (size_t i = 0; i < count; i++) {
+            bas::BasicSerializedView<Layout> record = reader[i];
+
+            CHECK(record.template popData<int>() == int(i));
+            CHECK(record.template popData<std::string>() == std::string(i, 'x'));
+            CHECK_THROWS(bas::PayloadError, record.template popData<int>());
+        }
+    }
+}
+
+TEST(batchReadRecords)
+{
+    readRecords<Fixed>();
+    readRecords<Varint>();
+    readRecords<Crc>();
+}
+
+template <typename Layout>
+static void malformedSize(void)
+{
+    std::string batch = sampleBatch<Layout>(3);
+
+    CHECK_THROWS(bas::PayloadError, bas::BasicBatchReader<Layout>(batch.data(), Layout::CHECKSUM_SIZE - 1));
+    CHECK_THROWS(bas::PayloadError, bas::BasicBatchReader<Layout>(batch.data(), batch.size() - 1));
+    writeSize<Layout>(batch.data(), Layout::CHECKSUM_SIZE);
+    CHECK_THROWS(bas::PayloadError, bas::BasicBatchReader<Layout>(batch.data(), batch.size()));
+}
+
+TEST(batchMalformedSizeThrows)
+{
+    malformedSize<Fixed>();
+    malformedSize<Varint>();
+    malformedSize<Crc>();
+}
+
+template <typename Layout>
+static void malformedTable(void)
+{
+    const size_t count = 3;
+    std::string valid = sampleBatch<Layout>(count);
+    size_t first = bas::Wire::load<Layout::LENGTH_SIZE>(valid.data() + tableEntry<Layout>(valid, count, 0));
+    size_t second = bas::Wire::load<Layout::LENGTH_SIZE>(valid.data() + tableEntry<Layout>(valid, count, 1));
+    auto withEntry = [&](size_t index, size_t value) {
+        std::string batch = valid;
+
+        bas::Wire::store<Layout::LENGTH_SIZE>(batch.data() + tableEntry<Layout>(batch, count, index), value);
+        Layout::writeChecksum(batch.data(), batch.size()); // Only the table is malformed, not the CRC
+        return batch;
+    };
+
+    for (const std::string& batch : {
+             withEntry(count, 1000), // Count bigger than the table
+             withEntry(0, 0), // Record inside the checksum of the batch
+             withEntry(0, second + 1), // Records out of order
+             withEntry(1, first), // Overlapping records
+             withEntry(2, tableEntry<Layout>(valid, count, 0)), // Record inside the table
+             withEntry(2, valid.size() + 1) }) {
+        CHECK_THROWS(bas::PayloadError, bas::BasicBatchReader<Layout>(batch.data(), batch.size()));
+    }
+}
+
+TEST(batchMalformedTableThrows)
+{
+    malformedTable<Fixed>();
+    malformedTable<Varint>();
+    malformedTable<Crc>();
+}
+
+TEST(batchCrcMismatchThrows)
+{
+    std::string batch = sampleBatch<Crc>(3);
+
+    for (size_t i = Crc::CHECKSUM_SIZE; i < batch.size(); i++) {
+        std::string corrupted = batch;
+
+        corrupted[i] ^= 0x01;
+        CHECK_THROWS(bas::PayloadError, bas::BasicBatchReader<Crc>(corrupted.data(), corrupted.size()));
+    }
+}
+
+int main(void)
+{
+    return runTests();
+}
@@ -0,0 +1,213 @@
+/*
+** ByteArraySerialisation
+** File description:
+** Bounds checks of the pops on malformed and truncated payloads.
+*/
+
+#include "bas.hpp"
+#include "check.hpp"
+#include "layouts.hpp"
+
+#include <string>
+#include <vector>
+
+template <typename Layout>
+static std::string samplePayload(void)
+{
+    bas::BasicSerializedObject<Layout> obj;
+
+    obj.pushData(42);
+    obj.pushData(std::vector<int> { 1, 2, 3, 4 });
+    obj.pushData(std::string("sample"));
+    return std::string(obj.payload(), obj.size());
+}
+
+template <typename Pop>
+static void popSample(Pop& pop)
+{
+    pop.template popData<int>();
+    pop.template popData<std::vector<int>>();
+    pop.template popData<std::string>();
+}
+
+template <typename Layout>
+static void popPastEnd(void)
+{
+    std::string payload = samplePayload<Layout>();
+    bas::BasicSerializedObject<Layout> obj(payload.data(), payload.size());
+    bas::BasicSerializedView<Layout> view(payload.data(), payload.size());
+
+    popSample(obj);
+    popSample(view);
+    CHECK_THROWS(bas::PayloadError, obj.template popData<int>());
+    CHECK_THROWS(bas::PayloadError, view.template popData<int>());
+    CHECK_THROWS(bas::PayloadError, view.template popData<std::string_view>());
+    CHECK_THROWS(bas::PayloadError, view.template popDataSpan<char>());
+}
+
+TEST(popPastEndThrows)
+{
+    popPastEnd<Fixed>();
+    popPastEnd<Varint>();
+    popPastEnd<Crc>();
+}
+
+// Every truncation of the payload cuts a field, popping it must throw instead of reading past the cut
+template <typename Layout>
+static void truncatedView(void)
+{
+    std::string payload = samplePayload<Layout>();
+
+    for (size_t size = Layout::CHECKSUM_SIZE; size < payload.size(); size++) {
+        bas::BasicSerializedView<Layout> view(payload.data(), size);
+
+        CHECK_THROWS(bas::PayloadError, popSample(view));
+    }
+}
+
+TEST(truncatedViewThrows)
+{
+    truncatedView<Fixed>();
+    truncatedView<Varint>();
+    truncatedView<Crc>();
+}
+
+template <typename Layout>
+static void receivedSizeMismatch(void)
+{
+    std::string payload = samplePayload<Layout>();
+
+    CHECK_THROWS(bas::PayloadError, bas::BasicSerializedObject<Layout>(payload.data(), Layout::CHECKSUM_SIZE - 1));
+    CHECK_THROWS(bas::PayloadError, bas::BasicSerializedObject<Layout>(payload.data(), payload.size() - 1));
+    writeSize<Layout>(payload.data(), Layout::CHECKSUM_SIZE - 1);
+    CHECK_THROWS(bas::PayloadError, bas::BasicSerializedObject<Layout>(payload.data(), payload.size()));
+}
+
+TEST(receivedSizeMismatchThrows)
+{
+    receivedSizeMismatch<Fixed>();
+    receivedSizeMismatch<Varint>();
+    receivedSizeMismatch<Crc>();
+}
+
+// Rewrites the sizes of the array field of samplePayload(), whose metadata must keep its length
+template <typename Layout>
+static std::string withArraySizes(size_t size, size_t array_size)
+{
+    std::string payload = samplePayload<Layout>();
+    char* field = payload.data() + Layout::CHECKSUM_SIZE + Layout::sizesLength(sizeof(int), 1) + sizeof(int);
+
+    CHECK(Layout::sizesLength(size, array_size) == Layout::sizesLength(sizeof(int), 4));
+    Layout::writeSizes(field, size, array_size);
+    Layout::writeChecksum(payload.data(), payload.size());
+    return payload;
+}
+
+template <typename Layout>
+static void sizesOutOfBounds(void)
+{
+    for (std::string payload : { withArraySizes<Layout>(sizeof(int), 100), withArraySizes<Layout>(100, 4), withArraySizes<Layout>(0, 4) }) {
+        bas::BasicSerializedObject<Layout> obj(payload.data(), payload.size());
+        bas::BasicSerializedView<Layout> view(payload.data(), payload.size());
+
+        obj.template popData<int>();
+        view.template popData<int>();
+        CHECK_THROWS(bas::PayloadError, obj.template popData<std::vector<int>>());
+        CHECK_THROWS(bas::PayloadError, view.template popData<std::vector<int>>());
+    }
+}
+
+TEST(sizesOutOfBoundsThrow)
+{
+    sizesOutOfBounds<Fixed>();
+    sizesOutOfBounds<Varint>();
+    sizesOutOfBounds<Crc>();
+}
+
+// A checksum smaller than itself must throw before anything is read after it, or before the CRC is computed
+template <typename Layout>
+static void shortHeader(void)
+{
+    for (size_t size = 0; size < Layout::CHECKSUM_SIZE; size++) {
+        std::vector<char> header(Layout::CHECKSUM_SIZE);
+        bas::BasicSerializedObject<Layout> obj;
+        bas::BasicCompressor<Layout> compressor;
+
+        writeSize<Layout>(header.data(), size);
+        CHECK(!Layout::HAS_CRC || !Layout::verifyChecksum(header.data(), size));
+        CHECK_THROWS(bas::PayloadError, bas::BasicSerializedObject<Layout>(header.data()));
+        CHECK_THROWS(bas::PayloadError, bas::BasicSerializedObject<Layout>(header.data(), std::pmr::get_default_resource()));
+        CHECK_THROWS(bas::PayloadError, bas::BasicSerializedObject<Layout>(header.data(), header.size()));
+        CHECK_THROWS(bas::PayloadError, obj = header.data());
+        CHECK_THROWS(bas::PayloadError, bas::BasicSerializedView<Layout>(header.data()));
+        CHECK_THROWS(bas::PayloadError, compressor.decompress(header.data(), header.size(), obj));
+        CHECK_THROWS(bas::PayloadError, bas::BasicFieldIndex<Layout>(header.data(), header.size()));
+        CHECK_THROWS(bas::PayloadError, bas::BasicSerializedObject<Layout>(header.data(), size)); // Truncated header
+        CHECK_THROWS(bas::PayloadError, compressor.decompress(header.data(), size, obj));
+    }
+}
+
+TEST(shortHeaderThrows)
+{
+    shortHeader<Fixed>();
+    shortHeader<Varint>();
+    shortHeader<Crc>();
+}
+
+// The element size stored in the payload must match the popped type
+template <typename Layout, typename Pop>
+static void popMismatched(Pop& pop)
+{
+    CHECK_THROWS(bas::PayloadError, pop.template popData<int>()); // A short
+    CHECK_THROWS(bas::PayloadError, pop.template popData<std::string>()); // Ints
+    CHECK_THROWS(bas::PayloadError, pop.template popData<std::string_view>()); // Ints
+    CHECK_THROWS(bas::PayloadError, pop.template popData<bas::BasicSerializedObject<Layout>>()); // Too short
+    CHECK_THROWS(bas::PayloadError, pop.template popData<bas::BasicSerializedObject<Layout>>()); // Not an object
+    CHECK(pop.template popData<bas::BasicSerializedObject<Layout>>().template popData<int>() == 42);
+}
+
+template <typename Layout>
+static void mismatchedSizes(void)
+{
+    bas::BasicSerializedObject<Layout> nested;
+    bas::BasicSerializedObject<Layout> obj;
+
+    nested.pushData(42);
+    obj.pushData(short(1));
+    obj.pushData(std::vector<int> { 1, 2 });
+    obj.pushData(std::vector<int> { 3, 4 });
+    obj.pushData(std::string(Layout::CHECKSUM_SIZE - 1, 'x'));
+    obj.pushData(std::string(64, 'x'));
+    obj.pushData(nested);
+    std::string payload(obj.payload(), obj.size());
+    bas::BasicSerializedView<Layout> view(payload.data(), payload.size());
+
+    popMismatched<Layout>(obj);
+    popMismatched<Layout>(view);
+}
+
+TEST(mismatchedSizesThrow)
+{
+    mismatchedSizes<Fixed>();
+    mismatchedSizes<Varint>();
+    mismatchedSizes<Crc>();
+}
+
+TEST(unterminatedVarintThrows)
+{
+    bas::BasicSerializedObject<Varint> obj;
+
+    obj.pushData(42);
+    std::string payload(obj.payload(), obj.size());
+
+    payload.replace(Varint::CHECKSUM_SIZE, std::string::npos, 4, '\xFF');
+    Varint::writeChecksum(payload.data(), payload.size());
+    bas::BasicSerializedView<Varint> view(payload.data(), payload.size());
+
+    CHECK_THROWS(bas::PayloadError, view.popData<int>());
+}
+
+int main(void)
+{
+    return runTests();
+}
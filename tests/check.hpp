@@ -0,0 +1,81 @@
+/*
+** ByteArraySerialisation
+** File description:
+** Minimal test harness: TEST() registers a test case, CHECK() and CHECK_THROWS() report failures,
+** runTests() runs every registered test case and returns the exit status of the test program.
+*/
+
+#ifndef BAS_TESTS_CHECK_HPP_
+#define BAS_TESTS_CHECK_HPP_
+
+#include <cstdio>
+#include <exception>
+#include <vector>
+
+struct TestCase {
+    const char* name;
+    void (*function)(void);
+};
+
+inline std::vector<TestCase>& testCases(void)
+{
+    static std::vector<TestCase> cases;
+    return cases;
+}
+
+inline size_t& testFailures(void)
+{
+    static size_t failures = 0;
+    return failures;
+}
+
+struct TestRegistration {
+    TestRegistration(const char* name, void (*function)(void))
+    {
+        testCases().push_back({ name, function });
+    }
+};
+
+inline void testFailure(const char* file, int line, const char* message)
+{
+    std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, message);
+    testFailures()++;
+}
+
+inline int runTests(void)
+{
+    for (const TestCase& test : testCases()) {
+        size_t failures = testFailures();
+
+        try {
+            test.function();
+        } catch (const std::exception& e) {
+            std::fprintf(stderr, "%s: unexpected exception: %s\n", test.name, e.what());
+            testFailures()++;
+        }
+        std::printf("%-48s %s\n", test.name, failures == testFailures() ? "ok" : "FAILED");
+    }
+    return testFailures() == 0 ? 0 : 1;
+}
+
+#define TEST(name)                                                         \
+    static void name(void);                                                \
+    static const TestRegistration name##Registration(#name, name);         \
+    static void name(void)
+
+#define CHECK(condition)                                                   \
+    do {                                                                   \
+        if (!(condition))                                                  \
+            testFailure(__FILE__, __LINE__, #condition);                   \
+    } while (0)
+
+#define CHECK_THROWS(Exception, expression)                                \
+    do {                                                                   \
+        try {                                                              \
+            expression;                                                    \
+            testFailure(__FILE__, __LINE__, #expression " did not throw"); \
+        } catch (const Exception&) {                                       \
+        }                                                                  \
+    } while (0)
+
+#endif /* !BAS_TESTS_CHECK_HPP_ */
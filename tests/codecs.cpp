@@ -0,0 +1,210 @@
+/*
+** ByteArraySerialisation
+** File description:
+** Round-trips of the encoded arrays, and decoding of malformed delta, run-length and LZ data.
+*/
+
+#include "bas.hpp"
+#include "check.hpp"
+#include "layouts.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using BigEndianCrc = bas::Crc32cLayout<bas::FixedLayout<4, 4, 8, bas::Endian::Big>>;
+
+// The Bytes of an encoded array: [codec][number of elements][encoded elements]
+static std::string encoded(bas::Codec codec, size_t count, const std::string& data)
+{
+    char header[1 + bas::Wire::MAX_VARINT_LENGTH];
+
+    header[0] = static_cast<char>(codec);
+    return std::string(header, 1 + bas::Wire::writeVarint(header + 1, count)) + data;
+}
+
+template <typename T>
+static std::vector<T> decode(const std::string& bytes)
+{
+    return bas::Codecs::decodeArray<Fixed, T>(bytes.data(), bytes.size());
+}
+
+template <typename T>
+static void checkMalformed(const std::string& bytes)
+{
+    CHECK_THROWS(bas::PayloadError, decode<T>(bytes));
+}
+
+template <typename Layout>
+static void roundTrip(void)
+{
+    std::vector<int> ramp(3000);
+    std::vector<int64_t> extremes { INT64_MIN, INT64_MAX, 0, -1, 1, INT64_MIN };
+    std::vector<float> repeated(2000, 1.5f);
+
+    for (size_t i = 0; i < ramp.size(); i++)
+        ramp[i] = int(1000 + i / 8 - i % 3);
+    repeated[1000] = 2.f;
+    for (bas::Codec codec : { bas::Codec::None, bas::Codec::Delta, bas::Codec::Rle, bas::Codec::Lz }) {
+        bas::BasicSerializedObject<Layout> obj;
+
+        obj.pushDataEncoded(ramp, codec);
+        obj.pushDataEncoded(extremes, codec);
+        obj.pushDataEncoded(std::vector<short>(), codec);
+        if (codec != bas::Codec::Delta)
+            obj.pushDataEncoded(repeated, codec);
+        obj.pushData(42);
+
+        bas::BasicSerializedView<Layout> view(obj.payload(), obj.size());
+
+        CHECK(view.template popDataEncoded<int>() == ramp);
+        CHECK(view.template popDataEncoded<int64_t>() == extremes);
+        CHECK(view.template popDataEncoded<short>().empty());
+        if (codec != bas::Codec::Delta)
+            CHECK(view.template popDataEncoded<float>() == repeated);
+        CHECK(view.template popData<int>() == 42);
+    }
+}
+
+TEST(encodedArraysRoundTrip)
+{
+    roundTrip<Fixed>();
+    roundTrip<Varint>();
+    roundTrip<BigEndianCrc>();
+}
+
+TEST(deltaOfNonIntegersThrows)
+{
+    bas::SerializedObject obj;
+
+    CHECK_THROWS(std::invalid_argument, obj.pushDataEncoded(std::vector<float>(4), bas::Codec::Delta));
+    checkMalformed<float>(encoded(bas::Codec::Delta, 1, std::string(1, '\0')));
+}
+
+TEST(malformedArrayHeaderThrows)
+{
+    checkMalformed<int>("");
+    checkMalformed<int>(std::string(1, char(bas::Codec::None)));
+    checkMalformed<int>(encoded(static_cast<bas::Codec>(7), 1, std::string(4, '\0')));
+    checkMalformed<int>(encoded(bas::Codec::None, size_t(1) << 40, ""));
+    checkMalformed<int>(encoded(bas::Codec::None, 3, std::string(8, '\0')));
+    checkMalformed<int>(encoded(bas::Codec::None, 1, std::string(5, '\0')));
+}
+
+TEST(malformedDeltaThrows)
+{
+    checkMalformed<int>(encoded(bas::Codec::Delta, 2, std::string(1, '\0'))); // Missing element
+    checkMalformed<int>(encoded(bas::Codec::Delta, 1, std::string(2, '\0'))); // Trailing Bytes
+    checkMalformed<int>(encoded(bas::Codec::Delta, 1, "\x80\x80")); // Unterminated varint
+    checkMalformed<int>(encoded(bas::Codec::Delta, 1, "\x80\x80\x80\x80\x80\x01")); // Wider than an int
+    CHECK((decode<int>(encoded(bas::Codec::Delta, 2, "\x03\x02")) == std::vector<int> { -2, -1 }));
+}
+
+TEST(malformedRleThrows)
+{
+    std::string element(4, '\x01');
+
+    checkMalformed<int>(encoded(bas::Codec::Rle, 2, '\0' + element)); // Empty run
+    checkMalformed<int>(encoded(bas::Codec::Rle, 2, '\3' + element)); // Run longer than the array
+    checkMalformed<int>(encoded(bas::Codec::Rle, 2, '\2' + element.substr(2))); // Truncated element
+    checkMalformed<int>(encoded(bas::Codec::Rle, 2, '\1' + element)); // Missing run
+    checkMalformed<int>(encoded(bas::Codec::Rle, 2, '\2' + element + '\0')); // Trailing Bytes
+    CHECK((decode<int>(encoded(bas::Codec::Rle, 2, '\2' + element)) == std::vector<int> { 0x01010101, 0x01010101 }));
+}
+
+// LZ sequences: [token][literals][offset on 2 Bytes], the token holds the literal length and the match length - 4
+static std::string lzMatch(size_t offset)
+{
+    char bytes[2];
+
+    bas::Wire::store<2>(bytes, offset);
+    return std::string(bytes, 2);
+}
+
+TEST(malformedLzThrows)
+{
+    std::string literals = "abcd";
+
+    checkMalformed<int>(encoded(bas::Codec::Lz, 2, "")); // No sequence
+    checkMalformed<int>(encoded(bas::Codec::Lz, 2, '\x40' + literals)); // Output too short
+    checkMalformed<int>(encoded(bas::Codec::Lz, 2, '\x80' + literals)); // Literals past the end of the input
+    checkMalformed<int>(encoded(bas::Codec::Lz, 1, '\x80' + literals + literals)); // Literals past the end of the output
+    checkMalformed<int>(encoded(bas::Codec::Lz, 2, '\x40' + literals + '\x04')); // Truncated offset
+    checkMalformed<int>(encoded(bas::Codec::Lz, 2, '\x40' + literals + lzMatch(0) + '\0')); // Null offset
+    checkMalformed<int>(encoded(bas::Codec::Lz, 2, '\x40' + literals + lzMatch(5) + '\0')); // Match before the output
+    checkMalformed<int>(encoded(bas::Codec::Lz, 2, '\x41' + literals + lzMatch(4) + '\0')); // Match past the end of the output
+    checkMalformed<int>(encoded(bas::Codec::Lz, 2, '\x40' + literals + lzMatch(4))); // Last sequence with a match
+    checkMalformed<int>(encoded(bas::Codec::Lz, 8, '\xF0' + std::string(1, '\xFF'))); // Truncated length extension
+
+    std::vector<int> decoded = decode<int>(encoded(bas::Codec::Lz, 2, '\x40' + literals + lzMatch(4) + '\0'));
+
+    CHECK(decoded.size() == 2 && std::string((const char*)decoded.data(), 8) == literals + literals);
+}
+
+template <typename Layout>
+static void corruptedPayload(void)
+{
+    std::vector<int> ramp(1000);
+    bas::BasicSerializedObject<Layout> obj;
+
+    for (size_t i = 0; i < ramp.size(); i++)
+        ramp[i] = int(i % 17);
+    for (bas::Codec codec : { bas::Codec::Delta, bas::Codec::Rle, bas::Codec::Lz })
+        obj.pushDataEncoded(ramp, codec);
+
+    std::string payload(obj.payload(), obj.size());
+
+    // Every corruption must either throw PayloadError or decode to arrays of the expected size, never read out of bounds
+    for (size_t i = Layout::CHECKSUM_SIZE; i < payload.size(); i++) {
+        std::string corrupted = payload;
+
+        corrupted[i] ^= 0x5A;
+        bas::BasicSerializedView<Layout> view(corrupted.data(), corrupted.size());
+
+        try {
+            for (size_t field = 0; field < 3; field++)
+                view.template popDataEncoded<int>();
+        } catch (const bas::PayloadError&) {
+        }
+    }
+}
+
+TEST(corruptedEncodedPayloadNeverOverflows)
+{
+    corruptedPayload<Fixed>();
+    corruptedPayload<Varint>();
+}
+
+template <typename Layout>
+static void compressedRoundTrip(void)
+{
+    bas::BasicSerializedObject<Layout> obj;
+
+    for (size_t i = 0; i < 8; i++)
+        obj.pushData(std::vector<int>(1000, int(i)));
+    obj.pushData(std::string(500, 'z'));
+    for (bas::Codec codec : { bas::Codec::None, bas::Codec::Rle, bas::Codec::Lz }) {
+        bas::BasicCompressor<Layout> compressor(codec);
+        bas::BasicSerializedObject<Layout> compressed = compressor.compress(obj);
+        bas::BasicSerializedObject<Layout> decompressed = compressor.decompress(bas::BasicSerializedView<Layout>(compressed));
+
+        CHECK(decompressed.size() == obj.size() && std::string(decompressed.payload(), obj.size()) == std::string(obj.payload(), obj.size()));
+        for (size_t cut = 0; cut < compressed.size(); cut++) {
+            bas::BasicSerializedObject<Layout> target;
+
+            CHECK_THROWS(bas::PayloadError, compressor.decompress(compressed.payload(), cut, target));
+        }
+    }
+}
+
+TEST(compressorRoundTrip)
+{
+    compressedRoundTrip<Fixed>();
+    compressedRoundTrip<Varint>();
+    compressedRoundTrip<BigEndianCrc>();
+}
+
+int main(void)
+{
+    return runTests();
+}
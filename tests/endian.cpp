@@ -0,0 +1,183 @@
+/*
+** ByteArraySerialisation
+** File description:
+** Byte order of the numbers stored by the little-endian and big-endian layouts, and the byte-swap kernels.
+*/
+
+#include "bas.hpp"
+#include "check.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using Little = bas::FixedLayout<2, 2, 4, bas::Endian::Little>;
+using Big = bas::FixedLayout<2, 2, 4, bas::Endian::Big>;
+using VarintBig = bas::VarintLayout<4, bas::Endian::Big>;
+using CrcBig = bas::Crc32cLayout<bas::FixedLayout<4, 4, 8, bas::Endian::Big>>;
+
+enum class Flag : uint16_t { A = 0x0102 };
+
+struct Point : bas::Reflectable<Point> {
+    BAS_FIELDS(x, y, flag)
+    int32_t x = 0;
+    double y = 0;
+    Flag flag = Flag::A;
+};
+
+// The Bytes of number in the given order, most significant first if big
+template <typename T>
+static std::string bytesOf(T number, bool big)
+{
+    std::string bytes(sizeof(T), '\0');
+    uint64_t value = 0;
+
+    std::memcpy(&value, &number, sizeof(T));
+    for (size_t i = 0; i < sizeof(T); i++)
+        bytes[big ? sizeof(T) - 1 - i : i] = static_cast<char>(value >> (8 * i));
+    return bytes;
+}
+
+// The Bytes of the first data of a payload
+template <typename Layout, typename T>
+static std::string storedBytes(const bas::BasicSerializedObject<Layout>& obj, size_t count)
+{
+    return std::string(obj.payload() + Layout::CHECKSUM_SIZE + Layout::sizesLength(sizeof(T), count), sizeof(T) * count);
+}
+
+template <typename Layout, typename T>
+static void storedInOrder(T number, bool big)
+{
+    bas::BasicSerializedObject<Layout> obj;
+
+    obj.pushData(number);
+    CHECK((storedBytes<Layout, T>(obj, 1) == bytesOf(number, big)));
+    CHECK(obj.template popData<T>() == number);
+}
+
+template <typename Layout>
+static void numbersInOrder(bool big)
+{
+    storedInOrder<Layout>(int16_t(0x0102), big);
+    storedInOrder<Layout>(int32_t(-0x01020304), big);
+    storedInOrder<Layout>(uint64_t(0x0102030405060708), big);
+    storedInOrder<Layout>(1.5f, big);
+    storedInOrder<Layout>(-2.25, big);
+    storedInOrder<Layout>(Flag::A, big);
+}
+
+TEST(numbersStoredInLayoutOrder)
+{
+    numbersInOrder<Little>(false);
+    numbersInOrder<Big>(true);
+    numbersInOrder<VarintBig>(true);
+    numbersInOrder<CrcBig>(true);
+}
+
+// Every count up to a few vectors, so that the SIMD kernels and the scalar tail are both used
+template <typename Layout, typename T>
+static void arraysInOrder(bool big)
+{
+    for (size_t count = 0; count < 80; count++) {
+        std::vector<T> numbers(count);
+        std::string expected;
+        bas::BasicSerializedObject<Layout> obj;
+
+        for (size_t i = 0; i < count; i++) {
+            numbers[i] = static_cast<T>(0x0102030405060708ull * (i + 1));
+            expected += bytesOf(numbers[i], big);
+        }
+        obj.pushData(numbers);
+        CHECK((storedBytes<Layout, T>(obj, count) == expected));
+
+        bas::BasicSerializedView<Layout> view(obj);
+
+        CHECK(obj.template popData<std::vector<T>>() == numbers);
+        CHECK(view.template popData<std::vector<T>>() == numbers);
+    }
+}
+
+template <typename Layout>
+static void allArraysInOrder(bool big)
+{
+    arraysInOrder<Layout, uint16_t>(big);
+    arraysInOrder<Layout, int32_t>(big);
+    arraysInOrder<Layout, uint64_t>(big);
+    arraysInOrder<Layout, double>(big);
+}
+
+TEST(arraysStoredInLayoutOrder)
+{
+    allArraysInOrder<Little>(false);
+    allArraysInOrder<Big>(true);
+    allArraysInOrder<VarintBig>(true);
+    allArraysInOrder<CrcBig>(true);
+}
+
+template <typename Layout>
+static void reflectableInOrder(bool big)
+{
+    Point point;
+    Point popped;
+
+    point.x = 0x01020304;
+    point.y = 3.5;
+    bas::BasicSerializedObject<Layout> obj = point.template serialize<Layout>();
+
+    CHECK((storedBytes<Layout, int32_t>(obj, 1) == bytesOf(point.x, big)));
+    popped.unserialize(obj);
+    CHECK(popped.x == point.x && popped.y == point.y && popped.flag == Flag::A);
+}
+
+TEST(reflectableStoredInLayoutOrder)
+{
+    reflectableInOrder<Little>(false);
+    reflectableInOrder<Big>(true);
+    reflectableInOrder<VarintBig>(true);
+    reflectableInOrder<CrcBig>(true);
+}
+
+// Reference of Wire::swapBytes(), reversing each number Byte by Byte
+template <size_t Bytes>
+static std::string reversed(const char* data, size_t count)
+{
+    std::string bytes(count * Bytes, '\0');
+
+    for (size_t i = 0; i < bytes.size(); i++)
+        bytes[i] = data[i / Bytes * Bytes + Bytes - 1 - i % Bytes];
+    return bytes;
+}
+
+template <size_t Bytes>
+static void swapKernel(void)
+{
+    for (size_t count = 0; count < 100; count++) {
+        std::string src(count * Bytes + 1, '\0');
+        std::string dst(count * Bytes + 1, '\0');
+
+        for (size_t i = 0; i < src.size(); i++)
+            src[i] = static_cast<char>(i * 7 + 1);
+
+        // Unaligned source and destination, then in place
+        bas::Wire::swapBytes<Bytes>(dst.data() + 1, src.data() + 1, count);
+        CHECK(dst.substr(1) == reversed<Bytes>(src.data() + 1, count));
+
+        std::string expected = reversed<Bytes>(src.data(), count);
+
+        bas::Wire::swapBytes<Bytes>(src.data(), src.data(), count);
+        CHECK(src.substr(0, count * Bytes) == expected);
+    }
+}
+
+TEST(swapKernels)
+{
+    swapKernel<2>();
+    swapKernel<4>();
+    swapKernel<8>();
+}
+
+int main(void)
+{
+    return runTests();
+}
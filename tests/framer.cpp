@@ -0,0 +1,155 @@
+/*
+** ByteArraySerialisation
+** File description:
+** StreamFramer on streams cut in every possible way, and on malformed size headers.
+*/
+
+#include "bas.hpp"
+#include "check.hpp"
+#include "layouts.hpp"
+
+#include <string>
+#include <vector>
+
+template <typename Layout>
+static std::string sampleStream(size_t count)
+{
+    std::string stream;
+
+    for (size_t i = 0; i < count; i++) {
+        bas::BasicSerializedObject<Layout> obj;
+
+        obj.pushData(int(i));
+        obj.pushData(std::string(i * 7, 'x'));
+        stream.append(obj.payload(), obj.size());
+    }
+    return stream;
+}
+
+template <typename Layout>
+static void checkFrame(bas::BasicSerializedView<Layout>& frame, size_t index)
+{
+    CHECK(frame.template popData<int>() == int(index));
+    CHECK(frame.template popData<std::string>() == std::string(index * 7, 'x'));
+}
+
+template <typename Layout>
+static void everyChunkSize(void)
+{
+    std::string stream = sampleStream<Layout>(16);
+
+    for (size_t chunk = 1; chunk <= stream.size(); chunk++) {
+        bas::BasicStreamFramer<Layout> framer;
+        bas::BasicSerializedView<Layout> frame;
+        size_t received = 0;
+
+        for (size_t offset = 0; offset < stream.size(); offset += chunk) {
+            framer.feed(stream.data() + offset, std::min(chunk, stream.size() - offset));
+            while (framer.next(frame))
+                checkFrame(frame, received++);
+        }
+        CHECK(received == 16);
+        CHECK(framer.pending() == 0);
+    }
+}
+
+TEST(framerEveryChunkSize)
+{
+    everyChunkSize<Fixed>();
+    everyChunkSize<Varint>();
+    everyChunkSize<Crc>();
+}
+
+template <typename Layout>
+static void nextObject(void)
+{
+    std::string stream = sampleStream<Layout>(4);
+    bas::BasicStreamFramer<Layout> framer;
+    bas::BasicSerializedObject<Layout> obj;
+    size_t received = 0;
+
+    framer.feed(stream.data(), stream.size() - 1);
+    while (framer.next(obj)) {
+        CHECK(obj.template popData<int>() == int(received++));
+    }
+    CHECK(received == 3);
+    framer.feed(stream.data() + stream.size() - 1, 1);
+    CHECK(framer.next(obj));
+    CHECK(obj.template popData<int>() == 3);
+    CHECK(!framer.next(obj));
+}
+
+TEST(framerNextObject)
+{
+    nextObject<Fixed>();
+    nextObject<Varint>();
+    nextObject<Crc>();
+}
+
+template <typename Layout>
+static void sizeOutOfBounds(void)
+{
+    std::string small(Layout::CHECKSUM_SIZE, '\0');
+    std::string big(Layout::CHECKSUM_SIZE, '\0');
+    bas::BasicSerializedView<Layout> frame;
+
+    writeSize<Layout>(small.data(), Layout::CHECKSUM_SIZE - 1);
+    writeSize<Layout>(big.data(), 1025);
+    for (const std::string& header : { small, big }) {
+        bas::BasicStreamFramer<Layout> framer(1024);
+
+        framer.feed(header.data(), header.size());
+        CHECK_THROWS(bas::PayloadError, framer.next(frame));
+    }
+    for (const std::string& header : { small, big }) {
+        bas::BasicStreamFramer<Layout> framer(1024);
+
+        framer.feed(header.data(), 1); // Split header, checked once it is buffered
+        CHECK(!framer.next(frame));
+        framer.feed(header.data() + 1, header.size() - 1);
+        CHECK_THROWS(bas::PayloadError, framer.next(frame));
+    }
+}
+
+TEST(framerSizeOutOfBoundsThrows)
+{
+    sizeOutOfBounds<Fixed>();
+    sizeOutOfBounds<Varint>();
+    sizeOutOfBounds<Crc>();
+}
+
+TEST(framerCrcMismatchSkipsPayload)
+{
+    std::string stream = sampleStream<Crc>(3);
+    bas::BasicStreamFramer<Crc> framer;
+    bas::BasicSerializedView<Crc> frame;
+
+    stream[Crc::CHECKSUM_SIZE] ^= 1; // First field of the first payload
+    framer.feed(stream.data(), stream.size());
+    CHECK_THROWS(bas::PayloadError, framer.next(frame));
+    CHECK(framer.next(frame));
+    checkFrame(frame, 1);
+    CHECK(framer.next(frame));
+    checkFrame(frame, 2);
+    CHECK(!framer.next(frame));
+}
+
+TEST(framerReset)
+{
+    std::string stream = sampleStream<Fixed>(2);
+    bas::BasicStreamFramer<Fixed> framer;
+    bas::BasicSerializedView<Fixed> frame;
+
+    framer.feed(stream.data(), 3);
+    CHECK(!framer.next(frame));
+    framer.reset();
+    CHECK(framer.pending() == 0);
+    framer.feed(stream.data(), stream.size());
+    CHECK(framer.next(frame));
+    checkFrame(frame, 0);
+}
+
+int main(void)
+{
+    return runTests();
+}
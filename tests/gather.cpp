@@ -0,0 +1,177 @@
+/*
+** ByteArraySerialisation
+** File description:
+** Arrays pushed by reference, listed by gather() and sized by serializedSize().
+*/
+
+#include "bas.hpp"
+#include "check.hpp"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+// Pushes its arrays by reference, or by copy to build the expected payload
+class Samples : public bas::Serializable {
+public:
+    void makeSerialization(bas::SerializedObject& obj) override
+    {
+        obj.pushData(id);
+        if (byRef)
+            obj.pushDataRef(values);
+        else
+            obj.pushData(values);
+    }
+
+    void makeUnserialization(bas::SerializedObject& obj) override
+    {
+        id = obj.popData<int>();
+        values = obj.popData<std::vector<int>>();
+    }
+
+    int id = 0;
+    std::vector<int> values;
+    bool byRef = true;
+};
+
+class Recording : public bas::Serializable {
+public:
+    void makeSerialization(bas::SerializedObject& obj) override
+    {
+        if (byRef)
+            obj.pushDataRef(header);
+        else
+            obj.pushData(header);
+        obj.pushObject(left);
+        obj.pushData(std::string("between"));
+        obj.pushObject(right);
+        if (byRef) {
+            obj.pushDataRef(std::vector<short>());
+            obj.pushDataRef(trailer);
+        } else {
+            obj.pushData(std::vector<short>());
+            obj.pushData(trailer);
+        }
+    }
+
+    void makeUnserialization(bas::SerializedObject& obj) override
+    {
+        header = obj.popData<std::vector<char>>();
+        obj.popObject(left);
+        obj.popData<std::string>();
+        obj.popObject(right);
+        obj.popData<std::vector<short>>();
+        trailer = obj.popData<std::vector<double>>();
+    }
+
+    void setByRef(bool ref)
+    {
+        byRef = ref;
+        left.byRef = ref;
+        right.byRef = ref;
+    }
+
+    std::vector<char> header;
+    Samples left;
+    Samples right;
+    std::vector<double> trailer;
+    bool byRef = true;
+};
+
+static Recording sampleRecording(void)
+{
+    Recording recording;
+
+    recording.header = { 'h', 'e', 'a', 'd' };
+    recording.left.id = 1;
+    recording.left.values = std::vector<int>(300, 7);
+    recording.right.id = 2;
+    recording.right.values = { 1, 2, 3 };
+    recording.trailer = std::vector<double>(50, 0.5);
+    return recording;
+}
+
+static std::string gathered(const bas::SerializedObject& obj)
+{
+    std::vector<bas::IoSegment> segments(obj.segmentCount());
+    std::string bytes;
+
+    CHECK(obj.gather(segments.begin()) == segments.end());
+    for (const bas::IoSegment& segment : segments)
+        bytes.append(segment.data, segment.size);
+    return bytes;
+}
+
+TEST(gatherMatchesPayload)
+{
+    Recording recording = sampleRecording();
+    Recording copied = sampleRecording();
+
+    copied.setByRef(false);
+    bas::SerializedObject obj = recording.serialize();
+    bas::SerializedObject expected = copied.serialize();
+    std::string bytes = gathered(obj);
+
+    CHECK(obj.segmentCount() > 1); // The arrays are not copied into the payload
+    CHECK(bytes.size() == obj.size() && obj.size() == expected.size());
+    CHECK(bytes == std::string(expected.payload(), expected.size()));
+#ifdef _BAS_HAS_IOVEC_
+    std::vector<struct iovec> iov(obj.segmentCount());
+    std::string written;
+
+    CHECK(obj.gather(iov.data()) == iov.size());
+    for (const struct iovec& segment : iov)
+        written.append((const char*)segment.iov_base, segment.iov_len);
+    CHECK(written == bytes);
+#endif
+    CHECK(std::string(obj.payload(), obj.size()) == bytes);
+    CHECK(obj.segmentCount() == 1); // payload() copied the arrays
+
+    Recording popped;
+
+    popped.unserialize(obj);
+    CHECK(popped.header == recording.header && popped.trailer == recording.trailer);
+    CHECK(popped.left.values == recording.left.values && popped.right.values == recording.right.values);
+}
+
+TEST(gatherConcurrentlyOnceChecksumWritten)
+{
+    Recording recording = sampleRecording();
+    bas::SerializedObject obj = recording.serialize();
+    size_t count = obj.segmentCount(); // Writes the checksum, gather() then only reads
+    std::string expected = gathered(obj);
+    std::vector<std::thread> threads;
+    std::vector<int> failures(4, 0);
+
+    for (size_t t = 0; t < failures.size(); t++) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < 100; i++)
+                failures[t] += obj.segmentCount() != count || gathered(obj) != expected;
+        });
+    }
+    for (std::thread& thread : threads)
+        thread.join();
+
+    int failed = 0;
+
+    for (int failure : failures)
+        failed += failure;
+    CHECK(failed == 0);
+    CHECK(count > 1); // Still not copied
+}
+
+TEST(serializedSizeCountsReferences)
+{
+    Recording recording = sampleRecording();
+    Samples samples;
+
+    samples.values = { 4, 5 };
+    CHECK(recording.serializedSize() == recording.serialize().size());
+    CHECK(recording.serialize(bas::sizing).size() == recording.serialize().size());
+    CHECK(samples.serializedSize() == samples.serialize().size());
+}
+
+int main(void)
+{
+    return runTests();
+}
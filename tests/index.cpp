@@ -0,0 +1,207 @@
+/*
+** ByteArraySerialisation
+** File description:
+** FieldIndex with and without trailer, and validation of malformed trailers.
+*/
+
+#include "bas.hpp"
+#include "check.hpp"
+#include "layouts.hpp"
+
+#include <string>
+#include <vector>
+
+static const size_t FIELDS = 50;
+
+template <typename Layout>
+static bas::BasicSerializedObject<Layout> sampleObject(void)
+{
+    bas::BasicSerializedObject<Layout> obj;
+    bas::BasicSerializedObject<Layout> nested;
+
+    for (size_t i = 0; i < FIELDS; i++) {
+        if (i % 3 == 0)
+            obj.pushData(std::string(i, char('a' + i % 26)));
+        else if (i % 3 == 1)
+            obj.pushData(int(i));
+        else
+            obj.pushData(std::vector<short>(i, short(i)));
+    }
+    nested.pushData(99);
+    obj.pushData(nested);
+    obj.pushData(std::vector<int>());
+    return obj;
+}
+
+template <typename Layout>
+static void checkFields(const bas::BasicFieldIndex<Layout>& index)
+{
+    CHECK(index.size() == FIELDS + 2);
+    for (size_t i = FIELDS; i-- > 0;) {
+        if (i % 3 == 0)
+            CHECK(index.template get<std::string>(i) == std::string(i, char('a' + i % 26)));
+        else if (i % 3 == 1)
+            CHECK(index.template get<int>(i) == int(i));
+        else
+            CHECK(index.template get<std::vector<short>>(i) == std::vector<short>(i, short(i)));
+    }
+    CHECK(index.template get<bas::BasicSerializedObject<Layout>>(FIELDS).template popData<int>() == 99);
+    CHECK(index.template get<std::vector<int>>(FIELDS + 1).empty());
+
+    bas::BasicSerializedView<Layout> last = index[FIELDS + 1];
+
+    last.template popData<std::vector<int>>();
+    CHECK_THROWS(bas::PayloadError, last.template popData<int>()); // The trailer cannot be popped
+}
+
+template <typename Layout>
+static void walkAndTrailer(void)
+{
+    bas::BasicSerializedObject<Layout> obj = sampleObject<Layout>();
+    bas::BasicFieldIndex<Layout> walked(obj);
+
+    CHECK(!walked.hasTrailer());
+    checkFields(walked);
+    bas::BasicFieldIndex<Layout>::pushTrailer(obj);
+    bas::BasicFieldIndex<Layout>::pushTrailer(obj); // Already has a trailer
+    bas::BasicFieldIndex<Layout> trailed(obj);
+
+    CHECK(trailed.hasTrailer());
+    CHECK(trailed.payload() == obj.payload() && trailed.payloadSize() == obj.size());
+    checkFields(trailed);
+    for (size_t i = 0; i < FIELDS + 2; i++)
+        CHECK(trailed.offset(i) == walked.offset(i));
+
+    bas::BasicSerializedView<Layout> sequential(obj.payload(), obj.size()); // Readers unaware of the trailer
+
+    sequential.template popData<std::string>();
+    CHECK(sequential.template popData<int>() == 1);
+}
+
+TEST(indexWalkAndTrailer)
+{
+    walkAndTrailer<Fixed>();
+    walkAndTrailer<Varint>();
+    walkAndTrailer<Crc>();
+}
+
+template <typename Layout>
+static void emptyAndFakeTrailer(void)
+{
+    bas::BasicSerializedObject<Layout> empty;
+    bas::BasicSerializedObject<Layout> fake;
+
+    bas::BasicFieldIndex<Layout>::pushTrailer(empty);
+    bas::BasicFieldIndex<Layout> emptyIndex(empty);
+
+    CHECK(emptyIndex.hasTrailer() && emptyIndex.size() == 0);
+    fake.pushData(1);
+    fake.pushData(std::string("BASINDX1"));
+    bas::BasicFieldIndex<Layout> fakeIndex(fake);
+
+    CHECK(!fakeIndex.hasTrailer() && fakeIndex.size() == 2 && fakeIndex.template get<int>(0) == 1);
+    fakeIndex.assign(empty.payload(), empty.size());
+    CHECK(fakeIndex.hasTrailer() && fakeIndex.size() == 0);
+}
+
+TEST(indexEmptyAndFakeTrailer)
+{
+    emptyAndFakeTrailer<Fixed>();
+    emptyAndFakeTrailer<Varint>();
+    emptyAndFakeTrailer<Crc>();
+}
+
+template <typename Layout>
+static void malformedPayload(void)
+{
+    bas::BasicSerializedObject<Layout> obj = sampleObject<Layout>();
+    std::string payload(obj.payload(), obj.size());
+
+    CHECK_THROWS(bas::PayloadError, bas::BasicFieldIndex<Layout>(payload.data(), Layout::CHECKSUM_SIZE - 1));
+    CHECK_THROWS(bas::PayloadError, bas::BasicFieldIndex<Layout>(payload.data(), payload.size() - 1));
+    writeSize<Layout>(payload.data(), payload.size() - 1); // Last field cut by the checksum
+    CHECK_THROWS(bas::PayloadError, bas::BasicFieldIndex<Layout>(payload.data(), payload.size()));
+}
+
+TEST(indexMalformedPayloadThrows)
+{
+    malformedPayload<Fixed>();
+    malformedPayload<Varint>();
+    malformedPayload<Crc>();
+}
+
+// Offset of the entry index of the trailer of a payload of count fields
+template <typename Layout>
+static size_t trailerEntry(const std::string& payload, size_t count, size_t index)
+{
+    return payload.size() - 8 - (count + 1 - index) * Layout::LENGTH_SIZE;
+}
+
+template <typename Layout>
+static std::string withTrailerEntry(const std::string& payload, size_t index, size_t value)
+{
+    std::string corrupted = payload;
+
+    bas::Wire::store<Layout::LENGTH_SIZE>(corrupted.data() + trailerEntry<Layout>(payload, FIELDS + 2, index), value);
+    Layout::writeChecksum(corrupted.data(), corrupted.size());
+    return corrupted;
+}
+
+template <typename Layout>
+static void malformedTrailer(void)
+{
+    bas::BasicSerializedObject<Layout> obj = sampleObject<Layout>();
+
+    bas::BasicFieldIndex<Layout>::pushTrailer(obj);
+    std::string payload(obj.payload(), obj.size());
+
+    // Offsets other than the last one are only checked when used
+    for (size_t offset : { size_t(0), Layout::CHECKSUM_SIZE - 1, payload.size(), size_t(-1) }) {
+        std::string corrupted = withTrailerEntry<Layout>(payload, 0, offset);
+        bas::BasicFieldIndex<Layout> index(corrupted.data(), corrupted.size());
+
+        CHECK(index.hasTrailer());
+        CHECK_THROWS(bas::PayloadError, index.offset(0));
+        CHECK_THROWS(bas::PayloadError, index[0]);
+        CHECK(index.template get<int>(1) == 1);
+    }
+    // A trailer whose count or last offset does not lead to it is not a trailer, the fields are walked instead
+    for (const std::string& corrupted : {
+             withTrailerEntry<Layout>(payload, FIELDS + 2, FIELDS + 1),
+             withTrailerEntry<Layout>(payload, FIELDS + 2, FIELDS + 3),
+             withTrailerEntry<Layout>(payload, FIELDS + 2, size_t(-1)),
+             withTrailerEntry<Layout>(payload, FIELDS + 1, 0),
+             withTrailerEntry<Layout>(payload, FIELDS + 1, payload.size()),
+             withTrailerEntry<Layout>(payload, FIELDS + 1, bas::BasicFieldIndex<Layout>(obj).offset(FIELDS)) }) {
+        bas::BasicFieldIndex<Layout> index(corrupted.data(), corrupted.size());
+
+        CHECK(!index.hasTrailer());
+        CHECK(index.size() == FIELDS + 3);
+        CHECK(index.template get<int>(1) == 1);
+    }
+    // Corrupting any Byte must throw PayloadError or index something, never read out of bounds
+    for (size_t i = 0; i < payload.size(); i++) {
+        std::string corrupted = payload;
+
+        corrupted[i] ^= 0x41;
+        try {
+            bas::BasicFieldIndex<Layout> index(corrupted.data(), corrupted.size());
+
+            for (size_t field = 0; field < index.size(); field++)
+                index[field].template popData<std::string_view>();
+        } catch (const bas::PayloadError&) {
+        }
+    }
+}
+
+TEST(indexMalformedTrailer)
+{
+    malformedTrailer<Fixed>();
+    malformedTrailer<Varint>();
+    malformedTrailer<Crc>();
+}
+
+int main(void)
+{
+    return runTests();
+}
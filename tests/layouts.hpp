@@ -0,0 +1,23 @@
+/*
+** ByteArraySerialisation
+** File description:
+** The layouts every test runs on, and helpers to forge malformed payloads.
+*/
+
+#ifndef BAS_TESTS_LAYOUTS_HPP_
+#define BAS_TESTS_LAYOUTS_HPP_
+
+#include "bas.hpp"
+
+using Fixed = bas::FixedLayout<2, 2, 4>;
+using Varint = bas::VarintLayout<4>;
+using Crc = bas::Crc32cLayout<bas::FixedLayout<4, 4, 8>>;
+
+// Writes the size of a payload without its CRC, which may then not match
+template <typename Layout>
+inline void writeSize(char* data, size_t size)
+{
+    bas::Wire::store<Layout::LENGTH_SIZE>(data, size);
+}
+
+#endif /* !BAS_TESTS_LAYOUTS_HPP_ */
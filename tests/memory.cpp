@@ -0,0 +1,132 @@
+/*
+** ByteArraySerialisation
+** File description:
+** Payloads allocated from custom memory resources, and the Arena reaching a steady state.
+*/
+
+#include "bas.hpp"
+#include "check.hpp"
+
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+// Counts the allocations it forwards to the default resource
+class Counting : public std::pmr::memory_resource {
+public:
+    size_t allocations = 0;
+    size_t live = 0;
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override
+    {
+        allocations++;
+        live++;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override
+    {
+        live--;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+class Message : public bas::Serializable {
+public:
+    void makeSerialization(bas::SerializedObject& obj) override
+    {
+        obj.pushData(id);
+        obj.pushData(text);
+        obj.pushData(values);
+    }
+
+    void makeUnserialization(bas::SerializedObject& obj) override
+    {
+        id = obj.popData<int>();
+        text = obj.popData<std::string>();
+        values = obj.popData<std::vector<int>>();
+    }
+
+    int id = 0;
+    std::string text;
+    std::vector<int> values;
+};
+
+static Message sampleMessage(int id)
+{
+    Message message;
+
+    message.id = id;
+    message.text = std::string(200, 't');
+    message.values = std::vector<int>(500, id);
+    return message;
+}
+
+TEST(customResourceUsed)
+{
+    Counting counting;
+
+    {
+        bas::SerializedObject obj(&counting);
+        bas::SerializedObject parent(&counting);
+
+        obj.pushData(std::string(1000, 'x'));
+        CHECK(obj.resource() == &counting && counting.allocations > 0);
+
+        size_t allocations = counting.allocations;
+        bas::SerializedObject serialized = sampleMessage(1).serialize(&counting);
+
+        CHECK(serialized.resource() == &counting && counting.allocations > allocations);
+        CHECK(bas::SerializedObject(serialized.payload(), serialized.size(), &counting).resource() == &counting);
+
+        // A popped nested object allocates from the resource of its parent
+        parent.pushData(obj);
+        bas::SerializedObject popped = parent.popData<bas::SerializedObject>();
+
+        CHECK(popped.resource() == &counting);
+        CHECK(popped.popData<std::string>() == std::string(1000, 'x'));
+    }
+    CHECK(counting.live == 0);
+}
+
+TEST(arenaSteadyState)
+{
+    Counting counting;
+    bas::Arena arena(4096, &counting);
+    size_t allocations = 0;
+    size_t capacity = 0;
+    bool identical = true;
+
+    for (int round = 0; round < 50; round++) {
+        arena.reset();
+        for (int i = 0; i < 20; i++) {
+            Message message = sampleMessage(i);
+            bas::SerializedObject obj = message.serialize(&arena);
+            Message popped;
+
+            popped.unserialize(obj);
+            identical = identical && popped.id == i && popped.text == message.text && popped.values == message.values;
+        }
+        // The first round gets the blocks from upstream, the next ones reuse them
+        if (round == 0) {
+            allocations = counting.allocations;
+            capacity = arena.capacity();
+        }
+    }
+    CHECK(identical);
+    CHECK(allocations > 0 && counting.allocations == allocations);
+    CHECK(arena.capacity() == capacity);
+    arena.release();
+    CHECK(counting.live == 0 && arena.capacity() == 0);
+}
+
+int main(void)
+{
+    return runTests();
+}
@@ -0,0 +1,233 @@
+/*
+** ByteArraySerialisation
+** File description:
+** Objects nested in place with pushObject() and popped with popObject().
+*/
+
+#include "bas.hpp"
+#include "check.hpp"
+
+#include <string>
+#include <vector>
+
+struct Pair : bas::Reflectable<Pair> {
+    BAS_FIELDS(a, b)
+    int a = 0, b = 0;
+};
+
+struct Triple : bas::Reflectable<Triple> {
+    BAS_FIELDS(a, b, c)
+    int a = 0, b = 0, c = 0;
+};
+
+struct Single : bas::Reflectable<Single> {
+    BAS_FIELDS(a)
+    int a = 0;
+};
+
+// Wraps Child between two siblings
+template <typename Child>
+struct Parent : bas::Reflectable<Parent<Child>> {
+    BAS_FIELDS(before, child, after)
+    int before = 0;
+    Child child;
+    int after = 0;
+};
+
+class Wallet : public bas::Serializable {
+public:
+    void makeSerialization(bas::SerializedObject& obj) override
+    {
+        obj.pushData(money);
+        obj.pushData(owner);
+    }
+
+    void makeUnserialization(bas::SerializedObject& obj) override
+    {
+        money = obj.popData<std::vector<int>>();
+        if (popOwner)
+            owner = obj.popData<std::string>();
+    }
+
+    std::vector<int> money;
+    std::string owner;
+    bool popOwner = true;
+};
+
+class Person : public bas::Serializable {
+public:
+    void makeSerialization(bas::SerializedObject& obj) override
+    {
+        obj.pushData(age);
+        obj.pushObject(wallet);
+        obj.pushObject(pair);
+        obj.pushData(name);
+    }
+
+    void makeUnserialization(bas::SerializedObject& obj) override
+    {
+        age = obj.popData<int>();
+        obj.popObject(wallet);
+        obj.popObject(pair);
+        name = obj.popData<std::string>();
+    }
+
+    int age = 0;
+    Wallet wallet;
+    Pair pair;
+    std::string name;
+};
+
+// Same payload as Parent, popped from the SerializedObject instead of a SerializedView
+template <typename Child>
+class Box : public bas::Serializable {
+public:
+    void makeSerialization(bas::SerializedObject& obj) override
+    {
+        obj.pushData(before);
+        obj.pushObject(child);
+        obj.pushData(after);
+    }
+
+    void makeUnserialization(bas::SerializedObject& obj) override
+    {
+        before = obj.popData<int>();
+        obj.popObject(child);
+        after = obj.popData<int>();
+    }
+
+    int before = 0;
+    Child child;
+    int after = 0;
+};
+
+// Pop the child nested in the payload of a Parent as a Popped
+template <typename Popped>
+static void popFromView(const bas::SerializedObject& obj)
+{
+    Parent<Popped> parent;
+
+    parent.unserialize(obj);
+}
+
+template <typename Popped>
+static void popFromObject(const bas::SerializedObject& obj)
+{
+    Box<Popped> box;
+
+    box.unserialize(obj);
+}
+
+TEST(serializableChildRoundTrip)
+{
+    Person person;
+    Person popped;
+
+    person.age = 32;
+    person.wallet.money = { 1, 2, 3 };
+    person.wallet.owner = "David";
+    person.pair.a = 4;
+    person.pair.b = 5;
+    person.name = "David";
+    popped.unserialize(person.serialize());
+    CHECK(popped.age == 32 && popped.name == "David");
+    CHECK(popped.wallet.money == person.wallet.money && popped.wallet.owner == "David");
+    CHECK(popped.pair.a == 4 && popped.pair.b == 5);
+}
+
+TEST(childPoppingLessThrows)
+{
+    Person person;
+    Person popped;
+
+    person.wallet.owner = "David";
+    popped.wallet.popOwner = false;
+    CHECK_THROWS(bas::PayloadError, popped.unserialize(person.serialize()));
+    CHECK_THROWS(bas::PayloadError, popFromView<Single>(Parent<Pair>().serialize()));
+    CHECK_THROWS(bas::PayloadError, popFromObject<Single>(Parent<Pair>().serialize()));
+}
+
+TEST(childPoppingMoreThrows)
+{
+    Parent<Pair> parent;
+
+    parent.after = 7;
+    // The third field of the child would be the sibling after it
+    CHECK_THROWS(bas::PayloadError, popFromView<Triple>(parent.serialize()));
+    CHECK_THROWS(bas::PayloadError, popFromObject<Triple>(parent.serialize()));
+}
+
+TEST(siblingsAfterChild)
+{
+    Parent<Pair> parent;
+    Parent<Pair> popped;
+    Box<Pair> box;
+
+    parent.before = 1;
+    parent.child.a = 2;
+    parent.child.b = 3;
+    parent.after = 4;
+    bas::SerializedObject obj = parent.serialize();
+
+    popped.unserialize(obj);
+    box.unserialize(obj);
+    CHECK(popped.before == 1 && popped.child.a == 2 && popped.child.b == 3 && popped.after == 4);
+    CHECK(box.before == 1 && box.child.a == 2 && box.child.b == 3 && box.after == 4);
+
+    bas::SerializedView view(obj);
+    bas::SerializedView nested;
+
+    CHECK(view.popData<int>() == 1);
+    nested = view.popData<bas::SerializedView>();
+    CHECK(bas::DefaultLayout::readChecksum(nested.payload()) == nested.size());
+    CHECK(view.popData<int>() == 4);
+}
+
+TEST(nestedChecksumMismatchThrows)
+{
+    bas::SerializedObject obj = Parent<Pair>().serialize();
+    std::string payload(obj.payload(), obj.size());
+    size_t nested = bas::DefaultLayout::CHECKSUM_SIZE + bas::DefaultLayout::sizesLength(sizeof(int), 1) + sizeof(int) + bas::DefaultLayout::NESTED_SIZES_LENGTH;
+
+    bas::DefaultLayout::writeChecksum(payload.data() + nested, 2);
+    CHECK_THROWS(bas::PayloadError, popFromView<Pair>(bas::SerializedObject(payload.data(), payload.size())));
+    CHECK_THROWS(bas::PayloadError, popFromObject<Pair>(bas::SerializedObject(payload.data(), payload.size())));
+}
+
+TEST(pushObjectAfterRemovedChecksum)
+{
+    bas::SerializedObject obj;
+    Pair pair;
+    Pair popped;
+
+    pair.a = 2;
+    pair.b = 3;
+    obj.pushData(7);
+    obj.removeChecksum();
+    obj.pushObject(pair);
+    obj.pushData(9);
+    bas::SerializedView view(obj);
+
+    CHECK(view.popData<int>() == 7);
+    view.popObject(popped);
+    CHECK(popped.a == 2 && popped.b == 3);
+    CHECK(view.popData<int>() == 9);
+}
+
+TEST(parentUnboundedAfterChildThrows)
+{
+    Parent<Pair> parent;
+    Triple triple;
+
+    parent.after = 4;
+    bas::SerializedObject obj = parent.serialize();
+
+    obj.popData<int>();
+    CHECK_THROWS(bas::PayloadError, obj.popObject(triple));
+    CHECK(obj.popData<int>() == 4);
+}
+
+int main(void)
+{
+    return runTests();
+}
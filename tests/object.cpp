@@ -0,0 +1,236 @@
+/*
+** ByteArraySerialisation
+** File description:
+** The life of a SerializedObject: finalizing, reading and moving it.
+*/
+
+#include "bas.hpp"
+#include "check.hpp"
+#include "layouts.hpp"
+
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+template <typename Layout>
+static void finalizedReadConcurrently(void)
+{
+    std::vector<int> values(1000, 3);
+    bas::BasicSerializedObject<Layout> obj;
+
+    obj.pushData(42);
+    obj.pushDataRef(values);
+    obj.pushData(std::string("end"));
+    obj.finalize();
+
+    // The const functions only read a finalized object, so the threads share it without a lock
+    const char* payload = obj.payload();
+    std::vector<std::thread> threads;
+    std::vector<int> failures(4, 0);
+
+    CHECK(obj.segmentCount() == 1);
+    for (size_t t = 0; t < failures.size(); t++) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < 100; i++) {
+                bas::BasicSerializedView<Layout> view(obj);
+
+                failures[t] += obj.payload() != payload || view.template popData<int>() != 42
+                    || view.template popData<std::vector<int>>() != values || view.template popData<std::string>() != "end";
+            }
+        });
+    }
+    for (std::thread& thread : threads)
+        thread.join();
+
+    int failed = 0;
+
+    for (int count : failures)
+        failed += count;
+    CHECK(failed == 0);
+    CHECK(bas::BasicSerializedObject<Layout>(obj.payload(), obj.size()).template popData<int>() == 42);
+}
+
+TEST(finalizedObjectReadConcurrently)
+{
+    finalizedReadConcurrently<Fixed>();
+    finalizedReadConcurrently<Varint>();
+    finalizedReadConcurrently<Crc>();
+}
+
+template <typename Pop>
+static bool popSample(Pop& pop)
+{
+    return pop.template popData<int>() == 42 && pop.template popData<std::vector<int>>() == std::vector<int>(100, 3)
+        && pop.template popData<std::string>() == "end";
+}
+
+template <typename Layout>
+static bas::BasicSerializedObject<Layout> sampleObject(void)
+{
+    bas::BasicSerializedObject<Layout> obj;
+
+    obj.pushData(42);
+    obj.pushData(std::vector<int>(100, 3));
+    obj.pushData(std::string("end"));
+    return obj;
+}
+
+template <typename Layout>
+static void rewindPopsAgain(void)
+{
+    bas::BasicSerializedObject<Layout> obj = sampleObject<Layout>();
+    std::string payload(obj.payload(), obj.size());
+    bas::BasicSerializedView<Layout> view(payload.data(), payload.size());
+
+    // Popping only moves the read cursor, the payload is left as it was
+    CHECK(popSample(obj) && popSample(view));
+    CHECK(std::string(obj.payload(), obj.size()) == payload);
+    CHECK_THROWS(bas::PayloadError, obj.template popData<int>());
+    obj.rewind();
+    view.rewind();
+    CHECK(popSample(obj) && popSample(view));
+
+    // Rewinding halfway, then pushing after the popped data
+    obj.rewind();
+    CHECK(obj.template popData<int>() == 42);
+    obj.rewind();
+    obj.pushData(7);
+    CHECK(popSample(obj) && obj.template popData<int>() == 7);
+
+    // Without its checksum, the payload starts at the first data
+    bas::BasicSerializedObject<Layout> removed = sampleObject<Layout>();
+
+    removed.removeChecksum();
+    CHECK(popSample(removed));
+    removed.rewind();
+    CHECK(popSample(removed));
+}
+
+TEST(rewindPopsFromStart)
+{
+    rewindPopsAgain<Fixed>();
+    rewindPopsAgain<Varint>();
+    rewindPopsAgain<Crc>();
+}
+
+template <typename Layout>
+static bool isEmpty(const bas::BasicSerializedObject<Layout>& obj)
+{
+    return obj.size() == Layout::CHECKSUM_SIZE && Layout::readChecksum(obj.payload()) == Layout::CHECKSUM_SIZE;
+}
+
+template <typename Layout>
+static void movedFromReused(void)
+{
+    bas::BasicSerializedObject<Layout> obj = sampleObject<Layout>();
+    const char* payload = obj.payload();
+
+    // The moved payload is not copied and keeps its read cursor
+    CHECK(obj.template popData<int>() == 42);
+    bas::BasicSerializedObject<Layout> moved(std::move(obj));
+
+    CHECK(moved.payload() == payload && moved.template popData<std::vector<int>>() == std::vector<int>(100, 3));
+    CHECK(isEmpty(obj));
+    CHECK_THROWS(bas::PayloadError, obj.template popData<int>());
+    CHECK(popSample(obj = sampleObject<Layout>()));
+
+    // Assigned from an object on another resource, the payload is copied into the resource of the target
+    std::pmr::monotonic_buffer_resource resource;
+    bas::BasicSerializedObject<Layout> other(&resource);
+
+    other.pushData(std::string(200, 'o'));
+    obj = std::move(other);
+    CHECK(obj.resource() == std::pmr::get_default_resource() && obj.template popData<std::string>() == std::string(200, 'o'));
+    CHECK(isEmpty(other) && other.resource() == &resource);
+    other.pushData(5);
+    CHECK(other.template popData<int>() == 5);
+
+    // A small payload stored inside the object moves too
+    bas::BasicSerializedObject<Layout> small;
+
+    small.pushData(1);
+    moved = std::move(small);
+    CHECK(moved.template popData<int>() == 1 && isEmpty(small));
+    small.pushData(std::vector<int>(100, 3));
+    CHECK(small.template popData<std::vector<int>>() == std::vector<int>(100, 3));
+}
+
+TEST(movedFromObjectReused)
+{
+    movedFromReused<Fixed>();
+    movedFromReused<Varint>();
+    movedFromReused<Crc>();
+}
+
+// Shifts the array by every offset: aligned, it is read in place, otherwise it is copied
+template <typename Layout, typename T>
+static void spanAlignment(void)
+{
+    std::vector<T> values(33);
+    size_t inPlace = 0;
+    size_t copied = 0;
+
+    for (size_t i = 0; i < values.size(); i++)
+        values[i] = static_cast<T>(i * 3 + 1);
+    for (size_t shift = 0; shift < 2 * alignof(T); shift++) {
+        bas::BasicSerializedObject<Layout> obj;
+
+        obj.pushData(std::vector<char>(shift, 's'));
+        obj.pushData(values);
+        obj.pushData(std::string("view"));
+        std::string payload(obj.payload(), obj.size());
+        bas::BasicSerializedView<Layout> view(payload.data(), payload.size());
+
+        for (int pass = 0; pass < 2; pass++) {
+            const char* begin = pass == 0 ? obj.payload() : view.payload();
+            bas::PoppedSpan<T> span;
+
+            if (pass == 0) {
+                obj.template popData<std::vector<char>>();
+                span = obj.template popDataSpan<T>();
+            } else {
+                view.template popData<std::vector<char>>();
+                span = view.template popDataSpan<T>();
+            }
+
+            const char* data = reinterpret_cast<const char*>(span.get());
+            bool inPayload = data >= begin && data < begin + payload.size();
+
+            CHECK(span.size() == values.size() && std::vector<T>(span.get(), span.get() + span.size()) == values);
+            CHECK(span.isCopy() != inPayload);
+            CHECK(reinterpret_cast<std::uintptr_t>(data) % alignof(T) == 0);
+            inPlace += !span.isCopy();
+            copied += span.isCopy();
+        }
+        std::string_view text = view.template popData<std::string_view>();
+
+        CHECK(text == "view" && text.data() >= view.payload() && text.data() < view.payload() + payload.size());
+    }
+    // Byte-swapped layouts always copy, the others read in place at least once
+    CHECK(copied > 0);
+    CHECK((inPlace > 0) == !(Layout::SWAP_BYTES && bas::Wire::isSwappable<T>));
+}
+
+template <typename Layout>
+static void spansAligned(void)
+{
+    spanAlignment<Layout, int16_t>();
+    spanAlignment<Layout, int32_t>();
+    spanAlignment<Layout, double>();
+}
+
+TEST(popDataSpanAlignment)
+{
+    spansAligned<Fixed>();
+    spansAligned<Varint>();
+    spansAligned<Crc>();
+    spansAligned<bas::FixedLayout<2, 2, 4, bas::Endian::Big>>();
+}
+
+int main(void)
+{
+    return runTests();
+}
@@ -0,0 +1,123 @@
+/*
+** ByteArraySerialisation
+** File description:
+** Batches serialized and read on several threads, against the same batches built on one thread.
+*/
+
+#include "bas.hpp"
+#include "check.hpp"
+#include "layouts.hpp"
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+struct Entity : bas::Reflectable<Entity> {
+    BAS_FIELDS(id, name, values)
+    int id = 0;
+    std::string name;
+    std::vector<int> values;
+};
+
+static std::vector<Entity> sampleEntities(size_t count)
+{
+    std::vector<Entity> entities(count);
+
+    for (size_t i = 0; i < count; i++) {
+        entities[i].id = int(i);
+        entities[i].name = std::string(i % 37, 'n');
+        entities[i].values = std::vector<int>(i % 11, int(i));
+    }
+    return entities;
+}
+
+template <typename Layout>
+static std::string finished(bas::BasicBatchWriter<Layout>& writer)
+{
+    bas::BasicSerializedObject<Layout> batch = writer.finish();
+
+    return std::string(batch.payload(), batch.size());
+}
+
+template <typename Layout>
+static void parallelMatchesSequential(void)
+{
+    for (size_t count : { 0, 10, 1000, 5000 }) {
+        std::vector<Entity> entities = sampleEntities(count);
+        std::vector<Entity*> pointers;
+        bas::BasicBatchWriter<Layout> sequential;
+        Entity first = sampleEntities(2)[1];
+
+        for (Entity& entity : entities)
+            pointers.push_back(&entity);
+        sequential.push(first);
+        for (Entity& entity : entities)
+            sequential.push(entity);
+
+        std::string expected = finished(sequential);
+
+        for (size_t threads : { 1, 2, 4, 7 }) {
+            bas::BasicBatchWriter<Layout> parallel;
+            bas::BasicBatchWriter<Layout> fromPointers;
+
+            // A record pushed before checks the offsets of the parallel records
+            parallel.push(first);
+            parallel.pushParallel(entities.begin(), entities.end(), threads);
+            fromPointers.push(first);
+            fromPointers.pushParallel(pointers.begin(), pointers.end(), threads);
+            CHECK(finished(parallel) == expected);
+            CHECK(finished(fromPointers) == expected);
+        }
+    }
+}
+
+TEST(pushParallelMatchesSequential)
+{
+    parallelMatchesSequential<Fixed>();
+    parallelMatchesSequential<Varint>();
+    parallelMatchesSequential<Crc>();
+}
+
+template <typename Layout>
+static void visitEachRecordOnce(void)
+{
+    std::vector<Entity> entities = sampleEntities(5000);
+    bas::BasicBatchWriter<Layout> writer;
+
+    writer.pushParallel(entities.begin(), entities.end(), 4);
+    std::string batch = finished(writer);
+    bas::BasicBatchReader<Layout> reader(batch.data(), batch.size());
+
+    for (size_t threads : { 1, 4, 16 }) {
+        std::vector<std::atomic<int>> visits(entities.size());
+        std::atomic<size_t> mismatches { 0 };
+
+        reader.forEachParallel([&](size_t index, bas::BasicSerializedView<Layout> record) {
+            Entity popped;
+
+            popped.unserialize(record);
+            visits[index]++;
+            if (popped.id != entities[index].id || popped.name != entities[index].name || popped.values != entities[index].values)
+                mismatches++;
+        }, threads);
+
+        size_t once = 0;
+
+        for (std::atomic<int>& count : visits)
+            once += count == 1;
+        CHECK(once == entities.size());
+        CHECK(mismatches == 0);
+    }
+}
+
+TEST(forEachParallelVisitsEachRecordOnce)
+{
+    visitEachRecordOnce<Fixed>();
+    visitEachRecordOnce<Varint>();
+    visitEachRecordOnce<Crc>();
+}
+
+int main(void)
+{
+    return runTests();
+}
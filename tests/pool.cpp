@@ -0,0 +1,124 @@
+/*
+** ByteArraySerialisation
+** File description:
+** clear() leaving a reusable payload, and ObjectPool recycling objects across threads.
+*/
+
+#include "bas.hpp"
+#include "check.hpp"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+static const size_t CHECKSUM_SIZE = bas::DefaultLayout::CHECKSUM_SIZE;
+
+// An object just acquired or cleared holds an empty payload, whose checksum is written on payload()
+static bool isEmpty(const bas::SerializedObject& obj)
+{
+    return obj.size() == CHECKSUM_SIZE && bas::DefaultLayout::readChecksum(obj.payload()) == CHECKSUM_SIZE;
+}
+
+// Pushes into obj and pops the pushed data back, from the start of the payload
+static bool roundTrip(bas::SerializedObject& obj, int value)
+{
+    obj.pushData(value);
+    obj.pushData(std::string(100, 'x'));
+    bas::SerializedObject received(obj.payload(), obj.size());
+
+    return obj.popData<int>() == value && received.popData<int>() == value && received.popData<std::string>() == std::string(100, 'x');
+}
+
+TEST(clearResetsPayloadAndReadState)
+{
+    bas::SerializedObject obj;
+
+    obj.reserve(4096);
+    CHECK(roundTrip(obj, 1));
+    obj.popData<std::string>();
+
+    size_t capacity = obj.capacity();
+
+    obj.clear();
+    CHECK(isEmpty(obj) && obj.capacity() == capacity);
+    CHECK_THROWS(bas::PayloadError, obj.popData<int>());
+    CHECK(roundTrip(obj, 2));
+
+    obj.removeChecksum();
+    obj.clear();
+    CHECK(isEmpty(obj) && obj.capacity() == capacity);
+    CHECK(roundTrip(obj, 3));
+}
+
+TEST(poolReusesCapacity)
+{
+    bas::ObjectPool pool;
+    bas::SerializedObject obj = pool.acquire();
+
+    CHECK(isEmpty(obj));
+    obj.reserve(4096);
+    CHECK(roundTrip(obj, 1));
+    pool.release(std::move(obj));
+    CHECK(obj.size() == CHECKSUM_SIZE);
+
+    bas::SerializedObject recycled = pool.acquire();
+
+    CHECK(isEmpty(recycled) && recycled.capacity() >= 4096);
+    CHECK(roundTrip(recycled, 2));
+    pool.release(bas::SerializedObject(bas::sizing)); // Not recycled
+    CHECK(!pool.acquire().isSizing());
+}
+
+TEST(poolAcrossThreads)
+{
+    const size_t objects = 100;
+    bas::ObjectPool pool(8);
+
+    // The cache of an exiting thread goes to the shared list, for the other threads
+    std::thread releaser([&] {
+        for (size_t i = 0; i < objects; i++) {
+            bas::SerializedObject obj(std::pmr::get_default_resource());
+
+            obj.reserve(8192);
+            pool.release(std::move(obj));
+        }
+    });
+    releaser.join();
+
+    size_t warm = 0;
+
+    for (size_t i = 0; i < objects; i++) {
+        bas::SerializedObject obj = pool.acquire();
+
+        warm += obj.capacity() >= 8192;
+        CHECK(isEmpty(obj));
+    }
+    CHECK(warm == objects);
+
+    std::vector<std::thread> threads;
+    std::vector<int> failures(4, 0);
+
+    for (size_t t = 0; t < failures.size(); t++) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < 10000; i++) {
+                bas::SerializedObject obj = pool.acquire();
+
+                failures[t] += !isEmpty(obj) || !roundTrip(obj, i);
+                pool.release(std::move(obj));
+            }
+        });
+    }
+    for (std::thread& thread : threads)
+        thread.join();
+
+    int failed = 0;
+
+    for (int count : failures)
+        failed += count;
+    CHECK(failed == 0);
+}
+
+int main(void)
+{
+    return runTests();
+}
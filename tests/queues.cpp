@@ -0,0 +1,144 @@
+/*
+** ByteArraySerialisation
+** File description:
+** SpscQueue and MpscQueue between threads, and their behaviour when full or empty.
+*/
+
+#include "bas.hpp"
+#include "check.hpp"
+
+#include <thread>
+#include <vector>
+
+static const size_t ITEMS = 100000;
+
+static bas::SerializedObject item(size_t producer, size_t sequence)
+{
+    bas::SerializedObject obj;
+
+    obj.pushData(producer);
+    obj.pushData(sequence);
+    return obj;
+}
+
+template <typename Queue>
+static void push(Queue& queue, bas::SerializedObject obj)
+{
+    while (!queue.tryPush(std::move(obj)))
+        std::this_thread::yield();
+}
+
+// Pops ITEMS items from each producer, alternating between the ways of popping, and checks their order
+template <typename Queue>
+static void consumeAll(Queue& queue, size_t producers)
+{
+    std::vector<size_t> next(producers, 0);
+    size_t received = 0;
+    size_t total = 0;
+    bool ordered = true;
+    bas::SerializedObject popped[8];
+    auto check = [&](bas::SerializedObject& obj) {
+        size_t producer = obj.popData<size_t>();
+        size_t sequence = obj.popData<size_t>();
+
+        ordered = ordered && producer < producers && sequence == next[producer];
+        if (producer < producers)
+            next[producer] = sequence + 1;
+        total += sequence;
+        received++;
+    };
+
+    for (size_t round = 0; received < producers * ITEMS; round++) {
+        size_t count = 0;
+
+        if (round % 3 == 0) {
+            count = queue.tryPop(popped[0]);
+        } else if (round % 3 == 1) {
+            count = queue.tryPop(popped, 8);
+        } else {
+            queue.consume(check, 5);
+            continue;
+        }
+        for (size_t i = 0; i < count; i++)
+            check(popped[i]);
+        if (count == 0)
+            std::this_thread::yield();
+    }
+    CHECK(ordered);
+    CHECK(received == producers * ITEMS);
+    CHECK(total == producers * (ITEMS * (ITEMS - 1) / 2));
+    CHECK(queue.empty() && queue.size() == 0);
+}
+
+TEST(spscOrderAndTotal)
+{
+    bas::SpscQueue queue(64);
+    std::thread producer([&] {
+        for (size_t i = 0; i < ITEMS; i++)
+            push(queue, item(0, i));
+    });
+
+    consumeAll(queue, 1);
+    producer.join();
+}
+
+TEST(mpscOrderAndTotal)
+{
+    const size_t producers = 4;
+    bas::MpscQueue queue(64);
+    std::vector<std::thread> threads;
+
+    for (size_t p = 0; p < producers; p++) {
+        threads.emplace_back([&queue, p] {
+            for (size_t i = 0; i < ITEMS; i++)
+                push(queue, item(p, i));
+        });
+    }
+    consumeAll(queue, producers);
+    for (std::thread& thread : threads)
+        thread.join();
+}
+
+template <typename Queue>
+static void fullAndEmpty(void)
+{
+    Queue queue(3);
+    bas::SerializedObject popped;
+
+    CHECK(queue.capacity() == 4);
+    CHECK(queue.empty() && !queue.tryPop(popped));
+    CHECK(queue.consume([](bas::SerializedObject&) {}) == 0);
+    for (size_t i = 0; i < 4; i++) {
+        bas::SerializedObject obj = item(0, i);
+
+        CHECK(queue.tryPush(std::move(obj)));
+        CHECK(obj.size() == bas::DefaultLayout::CHECKSUM_SIZE); // Moved into the queue
+    }
+
+    bas::SerializedObject rejected = item(0, 4);
+    size_t size = rejected.size();
+
+    CHECK(!queue.tryPush(std::move(rejected)));
+    CHECK(rejected.size() == size && rejected.popData<size_t>() == 0 && rejected.popData<size_t>() == 4);
+    CHECK(queue.size() == 4);
+
+    CHECK(queue.tryPop(popped));
+    CHECK(popped.popData<size_t>() == 0 && popped.popData<size_t>() == 0);
+    CHECK(queue.tryPush(item(0, 4)));
+    for (size_t i = 1; i <= 4; i++) {
+        CHECK(queue.tryPop(popped));
+        CHECK(popped.popData<size_t>() == 0 && popped.popData<size_t>() == i);
+    }
+    CHECK(queue.empty() && !queue.tryPop(popped));
+}
+
+TEST(fullAndEmptyQueue)
+{
+    fullAndEmpty<bas::SpscQueue>();
+    fullAndEmpty<bas::MpscQueue>();
+}
+
+int main(void)
+{
+    return runTests();
+}
@@ -0,0 +1,152 @@
+/*
+** ByteArraySerialisation
+** File description:
+** Reflectable round-trips, and the fields that make a class of fixed size.
+*/
+
+#include "bas.hpp"
+#include "check.hpp"
+#include "layouts.hpp"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+enum class Color : uint8_t { Red, Green };
+
+struct Vec3 : bas::Reflectable<Vec3> {
+    BAS_FIELDS(x, y, z)
+    float x = 0, y = 0, z = 0;
+};
+
+struct Pixel : bas::Reflectable<Pixel> {
+    BAS_FIELDS(x, y, color)
+    int x = 0, y = 0;
+    Color color = Color::Red;
+};
+
+struct Label : bas::Reflectable<Label> {
+    BAS_FIELDS(id, text)
+    int id = 0;
+    std::string_view text;
+};
+
+struct Envelope : bas::Reflectable<Envelope> {
+    BAS_FIELDS(id, body)
+    int id = 0;
+    bas::SerializedView body;
+};
+
+struct Entity : bas::Reflectable<Entity> {
+    BAS_FIELDS(id, position, name, tags, label)
+    int id = 0;
+    Vec3 position;
+    std::string name;
+    std::vector<int> tags;
+    Label label;
+};
+
+static_assert(Vec3::isFixedSize() && Pixel::isFixedSize());
+static_assert(!Label::isFixedSize() && !Envelope::isFixedSize() && !Entity::isFixedSize());
+static_assert(Label::fixedSize<Fixed>() == Fixed::sizesLength(sizeof(int), 1) + sizeof(int));
+static_assert(Envelope::fixedSize<Fixed>() == Fixed::sizesLength(sizeof(int), 1) + sizeof(int));
+
+template <typename Layout, typename T>
+static bas::BasicSerializedObject<Layout> serialized(const T& value)
+{
+    bas::BasicSerializedObject<Layout> obj = value.template serialize<Layout>();
+
+    CHECK(obj.size() == value.template serializedSize<Layout>());
+    return obj;
+}
+
+template <typename Layout>
+static void stringViewRoundTrip(void)
+{
+    std::string text = "a label longer than a pointer and a size";
+    Label label;
+    Label popped;
+
+    label.id = 7;
+    label.text = text;
+    bas::BasicSerializedObject<Layout> obj = serialized<Layout>(label);
+
+    text.assign(text.size(), '?'); // The payload must hold the characters, not a pointer to them
+    popped.unserialize(obj);
+    CHECK(popped.id == 7);
+    CHECK(popped.text == "a label longer than a pointer and a size");
+    CHECK(popped.text.data() >= obj.payload() && popped.text.data() < obj.payload() + obj.size());
+}
+
+TEST(stringViewFieldRoundTrip)
+{
+    stringViewRoundTrip<Fixed>();
+    stringViewRoundTrip<Varint>();
+    stringViewRoundTrip<Crc>();
+}
+
+template <typename Layout>
+static void viewFieldRoundTrip(void)
+{
+    bas::SerializedObject body;
+    Envelope envelope;
+    Envelope popped;
+
+    body.pushData(std::string("body"));
+    envelope.id = 3;
+    envelope.body = bas::SerializedView(body);
+    bas::BasicSerializedObject<Layout> obj = serialized<Layout>(envelope);
+
+    popped.unserialize(obj);
+    CHECK(popped.id == 3);
+    CHECK(popped.body.size() == body.size());
+    CHECK(popped.body.popData<std::string>() == "body");
+}
+
+TEST(viewFieldRoundTrip)
+{
+    viewFieldRoundTrip<Fixed>();
+    viewFieldRoundTrip<Varint>();
+    viewFieldRoundTrip<Crc>();
+}
+
+template <typename Layout>
+static void nestedRoundTrip(void)
+{
+    Entity entity;
+    Entity popped;
+    Pixel pixel;
+    Pixel poppedPixel;
+
+    entity.id = 1;
+    entity.position.x = 1.5f;
+    entity.position.z = -2.f;
+    entity.name = "entity";
+    entity.tags = { 1, 2, 3 };
+    entity.label.id = 9;
+    entity.label.text = "nested";
+    pixel.x = -4;
+    pixel.color = Color::Green;
+    bas::BasicSerializedObject<Layout> obj = serialized<Layout>(entity);
+    bas::BasicSerializedObject<Layout> pixelObj = serialized<Layout>(pixel);
+
+    CHECK(pixelObj.size() == Layout::CHECKSUM_SIZE + Pixel::fixedSize<Layout>());
+    popped.unserialize(obj);
+    poppedPixel.unserialize(pixelObj);
+    CHECK(popped.id == 1 && popped.position.x == 1.5f && popped.position.y == 0.f && popped.position.z == -2.f);
+    CHECK(popped.name == "entity" && popped.tags == entity.tags);
+    CHECK(popped.label.id == 9 && popped.label.text == "nested");
+    CHECK(poppedPixel.x == -4 && poppedPixel.y == 0 && poppedPixel.color == Color::Green);
+}
+
+TEST(nestedRoundTrip)
+{
+    nestedRoundTrip<Fixed>();
+    nestedRoundTrip<Varint>();
+    nestedRoundTrip<Crc>();
+}
+
+int main(void)
+{
+    return runTests();
+}
@@ -0,0 +1,150 @@
+/*
+** ByteArraySerialisation
+** File description:
+** serializedSize() of Serializable objects nesting other Serializable objects.
+*/
+
+#include "bas.hpp"
+#include "check.hpp"
+
+#include <string>
+#include <vector>
+
+class Leaf : public bas::Serializable {
+public:
+    void makeSerialization(bas::SerializedObject& obj) override
+    {
+        obj.pushData(id);
+        obj.pushData(name);
+        obj.pushData(values);
+    }
+
+    void makeUnserialization(bas::SerializedObject& obj) override
+    {
+        id = obj.popData<int>();
+        name = obj.popData<std::string>();
+        values = obj.popData<std::vector<double>>();
+    }
+
+    int id = 0;
+    std::string name;
+    std::vector<double> values;
+};
+
+// Nests its children both ways: as SerializedObjects returned by serialize(), and in place with pushObject()
+class Branch : public bas::Serializable {
+public:
+    void makeSerialization(bas::SerializedObject& obj) override
+    {
+        bas::SerializedObject first = left.serialize();
+
+        sizing = sizing || first.isSizing();
+        obj.pushData(first);
+        obj.pushObject(right);
+        obj.pushData(children.size());
+        for (Leaf& child : children)
+            obj.pushData(child.serialize());
+    }
+
+    void makeUnserialization(bas::SerializedObject& obj) override
+    {
+        bas::SerializedObject first = obj.popData<bas::SerializedObject>();
+
+        left.unserialize(first);
+        obj.popObject(right);
+        children.resize(obj.popData<size_t>());
+        for (Leaf& child : children) {
+            bas::SerializedObject nested = obj.popData<bas::SerializedObject>();
+
+            child.unserialize(nested);
+        }
+    }
+
+    Leaf left;
+    Leaf right;
+    std::vector<Leaf> children;
+    bool sizing = false; // Whether a nested serialize() returned a sizing object
+};
+
+class Root : public bas::Serializable {
+public:
+    void makeSerialization(bas::SerializedObject& obj) override
+    {
+        obj.pushData(std::string("root"));
+        obj.pushData(branch.serialize());
+        obj.pushObject(other);
+    }
+
+    void makeUnserialization(bas::SerializedObject& obj) override
+    {
+        obj.popData<std::string>();
+        bas::SerializedObject nested = obj.popData<bas::SerializedObject>();
+
+        branch.unserialize(nested);
+        obj.popObject(other);
+    }
+
+    Branch branch;
+    Branch other;
+};
+
+static Leaf sampleLeaf(int id)
+{
+    Leaf leaf;
+
+    leaf.id = id;
+    leaf.name = std::string(size_t(id) * 13, 'n');
+    leaf.values = std::vector<double>(size_t(id) * 7, 0.5);
+    return leaf;
+}
+
+static Branch sampleBranch(int id)
+{
+    Branch branch;
+
+    branch.left = sampleLeaf(id);
+    branch.right = sampleLeaf(id + 1);
+    for (int i = 0; i < id; i++)
+        branch.children.push_back(sampleLeaf(i));
+    return branch;
+}
+
+TEST(nestedSerializedSizeMatchesPayload)
+{
+    Root root;
+
+    root.branch = sampleBranch(3);
+    root.other = sampleBranch(10);
+    bas::SerializedObject obj = root.serialize();
+
+    CHECK(root.serializedSize() == obj.size());
+    CHECK(root.branch.serializedSize() == root.branch.serialize().size());
+    CHECK(root.other.serializedSize() == root.other.serialize().size());
+
+    bas::SerializedObject sized = root.serialize(bas::sizing);
+    Root popped;
+
+    CHECK(sized.size() == obj.size() && !sized.isSizing());
+    CHECK(std::string(sized.payload(), sized.size()) == std::string(obj.payload(), obj.size()));
+    popped.unserialize(sized);
+    CHECK(popped.other.children.size() == 10 && popped.other.children[9].values == root.other.children[9].values);
+    CHECK(popped.branch.left.name == root.branch.left.name && popped.branch.right.id == 4);
+}
+
+TEST(serializeDuringSizingIsSizing)
+{
+    Branch branch = sampleBranch(2);
+
+    branch.serialize();
+    CHECK(!branch.sizing);
+    branch.serializedSize();
+    CHECK(branch.sizing);
+
+    // The sizing pass is over, serialize() returns a payload again
+    CHECK(!branch.left.serialize().isSizing());
+}
+
+int main(void)
+{
+    return runTests();
+}